@@ -0,0 +1,62 @@
+#pragma once
+
+#include <oneapi/tbb/concurrent_queue.h>
+
+#include <atomic>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+
+namespace rad
+{
+    class CompletionManifest
+    {
+    public:
+        static constexpr std::string_view manifest_name{".rad_manifest"};
+        static constexpr std::size_t default_flush_threshold{64};
+
+        CompletionManifest(std::string const& root, std::string const& app_name);
+        CompletionManifest(std::string const& root,
+                           std::string const& app_name,
+                           std::size_t flush_threshold);
+
+        CompletionManifest(CompletionManifest const&) = delete;
+        CompletionManifest(CompletionManifest&&)      = delete;
+        ~CompletionManifest();
+
+        CompletionManifest& operator=(CompletionManifest const&) = delete;
+        CompletionManifest& operator=(CompletionManifest&&)      = delete;
+
+        [[nodiscard]]
+        bool is_complete(std::string const& name) const;
+
+        void mark_complete(std::string const& name);
+        void flush();
+
+        [[nodiscard]]
+        std::size_t num_completed() const;
+
+        [[nodiscard]]
+        std::filesystem::path const& path() const;
+
+    private:
+        void write_pending();
+
+        std::filesystem::path m_path;
+        std::size_t m_flush_threshold;
+
+        // Entries loaded from a previous run. This is never modified after
+        // construction, so lookups don't need to be synchronised.
+        std::unordered_set<std::string> m_completed;
+
+        oneapi::tbb::concurrent_queue<std::string> m_pending;
+        std::atomic<std::size_t> m_num_pending{0};
+        std::atomic<std::size_t> m_num_new{0};
+        std::mutex m_write_mutex;
+        std::ofstream m_stream;
+    };
+} // namespace rad
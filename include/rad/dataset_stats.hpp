@@ -0,0 +1,39 @@
+#pragma once
+
+#include <opencv2/core/types.hpp>
+#include <opencv2/imgcodecs.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace rad
+{
+    struct DatasetStatsOptions
+    {
+        int flags{cv::IMREAD_COLOR};
+
+        // Only every n-th file (in sorted order) is used.
+        std::size_t sample_stride{1};
+
+        // When positive, images are decoded at reduced resolution so that their long
+        // edge is close to this value. Zero decodes them at full resolution.
+        int long_edge{0};
+    };
+
+    struct DatasetStats
+    {
+        cv::Scalar mean;
+        cv::Scalar std;
+        int channels{0};
+        std::uint64_t num_images{0};
+        std::uint64_t num_pixels{0};
+    };
+
+    // Computes the per-channel mean and standard deviation of the images under root in
+    // the same normalised units used by to_normalised_float, so the results can be
+    // passed to it directly.
+    DatasetStats compute_dataset_stats(std::string const& root,
+                                       DatasetStatsOptions const& options);
+    DatasetStats compute_dataset_stats(std::string const& root);
+} // namespace rad
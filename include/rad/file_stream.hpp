@@ -0,0 +1,46 @@
+#pragma once
+
+#include <oneapi/tbb/concurrent_queue.h>
+#include <oneapi/tbb/task_group.h>
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <thread>
+
+namespace rad
+{
+    // Lists every file under root on a background thread. At most capacity paths are
+    // queued ahead of the consumer, so the scan never holds the whole listing in memory.
+    class FileStream
+    {
+    public:
+        static constexpr std::size_t default_capacity{4096};
+
+        explicit FileStream(std::string const& root);
+        FileStream(std::string const& root, std::size_t capacity);
+
+        FileStream(FileStream const&) = delete;
+        FileStream(FileStream&&)      = delete;
+        ~FileStream();
+
+        FileStream& operator=(FileStream const&) = delete;
+        FileStream& operator=(FileStream&&)      = delete;
+
+        [[nodiscard]]
+        std::optional<std::filesystem::path> next();
+
+    private:
+        void scan(std::filesystem::path const& dir);
+
+        oneapi::tbb::concurrent_bounded_queue<std::filesystem::path> m_queue;
+        oneapi::tbb::task_group m_tasks;
+        std::atomic<bool> m_stop{false};
+        std::atomic<bool> m_done{false};
+        std::exception_ptr m_error;
+        std::thread m_scanner;
+    };
+} // namespace rad
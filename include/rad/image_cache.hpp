@@ -0,0 +1,122 @@
+#pragma once
+
+#include <opencv2/core/mat.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <list>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace rad
+{
+    struct ImageCacheKey
+    {
+        std::string path;
+        int flags{0};
+        std::filesystem::file_time_type mtime;
+
+        bool operator==(ImageCacheKey const&) const = default;
+    };
+
+    struct ImageCacheKeyHash
+    {
+        std::size_t operator()(ImageCacheKey const& key) const;
+    };
+
+    // Keeps decoded images in memory so repeated loads of the same file skip decoding.
+    // Entries are spread over independently locked shards that share one byte budget.
+    // An insert evicts from its own shard first and only takes space from the other
+    // shards when that isn't enough, so a single image may use the whole budget.
+    // Lookups only take a shared lock and stamp the entry they hit, and the LRU order
+    // of a shard is brought up to date lazily when it has to evict, so concurrent
+    // lookups never block each other and eviction is approximately LRU.
+    class ImageCache
+    {
+    public:
+        static constexpr std::size_t default_num_shards{16};
+
+        explicit ImageCache(std::size_t max_bytes);
+        ImageCache(std::size_t max_bytes, std::size_t num_shards);
+
+        ImageCache(ImageCache const&) = delete;
+        ImageCache(ImageCache&&)      = delete;
+        ~ImageCache()                 = default;
+
+        ImageCache& operator=(ImageCache const&) = delete;
+        ImageCache& operator=(ImageCache&&)      = delete;
+
+        // Returns an empty optional if the modification time of the file can't be
+        // read.
+        [[nodiscard]]
+        static std::optional<ImageCacheKey> get_key(std::filesystem::path const& path,
+                                                    int flags);
+
+        // The returned image shares its pixels with the cache, so it must be cloned
+        // before it is modified.
+        [[nodiscard]]
+        std::optional<cv::Mat> find(ImageCacheKey const& key);
+
+        // Empty images and images larger than the whole budget aren't stored.
+        void insert(ImageCacheKey const& key, cv::Mat const& img);
+
+        void clear();
+
+        [[nodiscard]]
+        std::size_t max_bytes() const;
+
+        [[nodiscard]]
+        std::size_t size_bytes() const;
+
+        [[nodiscard]]
+        std::size_t num_entries() const;
+
+        [[nodiscard]]
+        std::size_t num_hits() const;
+
+        [[nodiscard]]
+        std::size_t num_misses() const;
+
+    private:
+        struct Entry
+        {
+            Entry(ImageCacheKey k, cv::Mat i, std::size_t b, std::uint64_t stamp);
+
+            ImageCacheKey key;
+            cv::Mat img;
+            std::size_t bytes;
+            std::uint64_t position;
+            std::atomic<std::uint64_t> last_used;
+        };
+
+        struct Shard
+        {
+            mutable std::shared_mutex mutex;
+            std::list<Entry> entries;
+            std::unordered_map<ImageCacheKey,
+                               std::list<Entry>::iterator,
+                               ImageCacheKeyHash>
+                index;
+            std::size_t bytes{0};
+        };
+
+        [[nodiscard]]
+        Shard& get_shard(ImageCacheKey const& key);
+
+        // Evicts from the shard until bytes more fit in the budget or the shard is
+        // empty. The shard must be locked exclusively.
+        void evict(Shard& shard, std::size_t bytes);
+
+        std::size_t m_max_bytes;
+        std::vector<Shard> m_shards;
+        std::atomic<std::size_t> m_size_bytes{0};
+        std::atomic<std::uint64_t> m_clock{0};
+        std::atomic<std::size_t> m_num_hits{0};
+        std::atomic<std::size_t> m_num_misses{0};
+    };
+} // namespace rad
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "mapped_file.hpp"
+
+#include <opencv2/core/mat.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace rad
+{
+    // A shard stores already decoded images so they can be read back without decoding
+    // them again. The layout is a fixed-size header, the raw pixels of every image with
+    // each record aligned to ImageShard::alignment bytes, and an index at the end with
+    // the offset, shape, type and name of each record. All values are little-endian.
+    struct ShardRecord
+    {
+        std::string name;
+        std::uint64_t offset{0};
+        int rows{0};
+        int cols{0};
+        int type{0};
+    };
+
+    class ImageShardWriter
+    {
+    public:
+        explicit ImageShardWriter(std::filesystem::path const& path);
+
+        ImageShardWriter(ImageShardWriter const&) = delete;
+        ImageShardWriter(ImageShardWriter&&)      = delete;
+        ~ImageShardWriter();
+
+        ImageShardWriter& operator=(ImageShardWriter const&) = delete;
+        ImageShardWriter& operator=(ImageShardWriter&&)      = delete;
+
+        void add(std::string const& name, cv::Mat const& img);
+
+        // Writes the index and header. The shard can't be read until this has been
+        // called. A writer destroyed before finishing, such as by an exception while
+        // adding images, deletes the file so a partial shard is never mistaken for a
+        // complete one.
+        void finish();
+
+        [[nodiscard]]
+        std::size_t size() const;
+
+    private:
+        std::filesystem::path m_path;
+        std::ofstream m_stream;
+        std::vector<ShardRecord> m_records;
+        std::uint64_t m_pos{0};
+        bool m_finished{false};
+    };
+
+    class ImageShard
+    {
+    public:
+        static constexpr std::string_view magic{"RADSHARD"};
+        static constexpr std::uint32_t version{1};
+        static constexpr std::size_t header_size{64};
+        static constexpr std::size_t alignment{64};
+
+        explicit ImageShard(std::filesystem::path const& path);
+
+        ImageShard(ImageShard const&) = delete;
+        ImageShard(ImageShard&&)      = delete;
+        ~ImageShard()                 = default;
+
+        ImageShard& operator=(ImageShard const&) = delete;
+        ImageShard& operator=(ImageShard&&)      = delete;
+
+        [[nodiscard]]
+        std::vector<ShardRecord> const& records() const;
+
+        [[nodiscard]]
+        std::size_t size() const;
+
+        // Returns a view of the pixels of the record that points into the mapped
+        // shard. The shard is mapped copy-on-write, so the view can be modified freely
+        // without affecting the file. It must not outlive the shard.
+        [[nodiscard]]
+        cv::Mat image(ShardRecord const& record) const;
+
+        [[nodiscard]]
+        cv::Mat image(std::size_t index) const;
+
+    private:
+        MappedFile m_file;
+        std::vector<ShardRecord> m_records;
+    };
+
+    // Decodes every image under root and packs them into a shard at path. Files that
+    // don't decode to an image are skipped.
+    void write_image_shard(std::string const& root,
+                           std::filesystem::path const& path,
+                           int flags);
+    void write_image_shard(std::string const& root, std::filesystem::path const& path);
+} // namespace rad
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+namespace rad
+{
+    enum class MapMode
+    {
+        read_only = 0,
+
+        // Pages can be written to, but writes are private to the process and never
+        // reach the file. Pages are only copied when they are first written.
+        copy_on_write,
+    };
+
+    // Tells the OS how the mapping will be read so it can tune read-ahead.
+    enum class AccessHint
+    {
+        sequential = 0,
+        random,
+        normal,
+    };
+
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+        explicit MappedFile(std::filesystem::path const& path);
+        MappedFile(std::filesystem::path const& path, MapMode mode);
+        MappedFile(std::filesystem::path const& path, MapMode mode, AccessHint hint);
+
+        MappedFile(MappedFile const&) = delete;
+        MappedFile(MappedFile&& other) noexcept;
+        ~MappedFile();
+
+        MappedFile& operator=(MappedFile const&) = delete;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+
+        [[nodiscard]]
+        std::uint8_t const* data() const;
+
+        [[nodiscard]]
+        std::size_t size() const;
+
+        [[nodiscard]]
+        bool empty() const;
+
+        void unmap();
+
+    private:
+        std::uint8_t const* m_data{nullptr};
+        std::size_t m_size{0};
+    };
+} // namespace rad
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+
+namespace rad
+{
+    class MemoryBudget
+    {
+    public:
+        class Reservation
+        {
+        public:
+            Reservation()                   = default;
+            Reservation(Reservation const&) = delete;
+            Reservation(Reservation&& other) noexcept;
+            ~Reservation();
+
+            Reservation& operator=(Reservation const&) = delete;
+            Reservation& operator=(Reservation&& other) noexcept;
+
+            [[nodiscard]]
+            std::size_t size() const;
+
+            void release();
+
+        private:
+            friend class MemoryBudget;
+
+            Reservation(MemoryBudget* budget, std::size_t bytes);
+
+            MemoryBudget* m_budget{nullptr};
+            std::size_t m_bytes{0};
+        };
+
+        explicit MemoryBudget(std::size_t max_bytes);
+
+        MemoryBudget(MemoryBudget const&) = delete;
+        MemoryBudget(MemoryBudget&&)      = delete;
+        ~MemoryBudget()                   = default;
+
+        MemoryBudget& operator=(MemoryBudget const&) = delete;
+        MemoryBudget& operator=(MemoryBudget&&)      = delete;
+
+        [[nodiscard]]
+        Reservation reserve(std::size_t bytes);
+
+        [[nodiscard]]
+        std::size_t max_bytes() const;
+
+        [[nodiscard]]
+        std::size_t bytes_in_flight() const;
+
+        [[nodiscard]]
+        std::size_t peak_bytes_in_flight() const;
+
+    private:
+        void release(std::size_t bytes);
+
+        std::size_t m_max_bytes;
+        std::size_t m_in_flight{0};
+        std::size_t m_peak{0};
+        mutable std::mutex m_mutex;
+        std::condition_variable m_released;
+    };
+} // namespace rad
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace rad
+{
+    enum class ReaderBackend
+    {
+        automatic = 0,
+        io_uring,
+        thread_pool,
+    };
+
+    struct FileBuffer
+    {
+        std::filesystem::path path;
+        std::vector<std::uint8_t> bytes;
+    };
+
+    class PrefetchReader
+    {
+    public:
+        static constexpr std::size_t num_pool_threads{4};
+
+        PrefetchReader(std::vector<std::filesystem::path> files, std::size_t window);
+        PrefetchReader(std::vector<std::filesystem::path> files,
+                       std::size_t window,
+                       ReaderBackend backend);
+
+        PrefetchReader(PrefetchReader const&) = delete;
+        PrefetchReader(PrefetchReader&&)      = delete;
+        ~PrefetchReader();
+
+        PrefetchReader& operator=(PrefetchReader const&) = delete;
+        PrefetchReader& operator=(PrefetchReader&&)      = delete;
+
+        // Files that can't be read come back with no bytes, so they decode to an empty
+        // image the same as they would through load_image.
+        [[nodiscard]]
+        std::optional<FileBuffer> next();
+
+        [[nodiscard]]
+        ReaderBackend backend() const;
+
+        [[nodiscard]]
+        static bool is_io_uring_available();
+
+    private:
+        class Impl;
+        std::unique_ptr<Impl> m_impl;
+    };
+} // namespace rad
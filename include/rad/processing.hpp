@@ -1,23 +1,570 @@
 #pragma once
 
+#include "completion_manifest.hpp"
+#include "file_stream.hpp"
+#include "image_cache.hpp"
+#include "image_shard.hpp"
+#include "memory_budget.hpp"
+#include "prefetch_reader.hpp"
 #include "processing_util.hpp"
+#include "profiling.hpp"
+#include "progress.hpp"
+#include "result_cache.hpp"
+#include "tar_archive.hpp"
+#include "tiled_raster.hpp"
+#include "video_reader.hpp"
+#include "worker_arena.hpp"
 
+#include <fmt/format.h>
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/concurrent_vector.h>
+#include <oneapi/tbb/enumerable_thread_specific.h>
 #include <oneapi/tbb/parallel_for_each.h>
+#include <oneapi/tbb/parallel_pipeline.h>
+#include <oneapi/tbb/parallel_reduce.h>
+#include <oneapi/tbb/task_arena.h>
+#include <opencv2/core.hpp>
 #include <opencv2/imgcodecs.hpp>
+#include <opencv2/videoio.hpp>
 
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
 #include <filesystem>
+#include <optional>
+#include <stdexcept>
 #include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace rad
 {
+    enum class PartialBatchPolicy
+    {
+        keep = 0,
+        drop,
+        pad,
+    };
+
+    enum class SchedulingPolicy
+    {
+        directory_order = 0,
+        largest_first,
+        balanced,
+    };
+
+    struct ProcessingFailure
+    {
+        std::string path;
+        std::string message;
+    };
+
+    namespace detail
+    {
+        struct ImageToken
+        {
+            std::filesystem::path path;
+            std::string filename;
+            std::vector<std::uint8_t> bytes;
+            cv::Mat img;
+        };
+
+        template<typename ImageProcessFun>
+        using ImageResult =
+            std::invoke_result_t<ImageProcessFun&, std::string&, cv::Mat&>;
+
+        template<typename FileProcessFun>
+        using FileResult = std::invoke_result_t<FileProcessFun&, std::string const&>;
+
+        template<typename FrameProcessFun>
+        using FrameResult = std::invoke_result_t<FrameProcessFun&, std::size_t, cv::Mat&>;
+
+        template<typename StateFactory>
+        using WorkerState = std::invoke_result_t<StateFactory&>;
+
+        // Runs fun over the files with a state object per worker thread. The states
+        // are created lazily from the factory the first time a thread needs one and
+        // are reused for every file that thread processes afterwards.
+        template<typename StateFactory, typename StateProcessFun>
+        oneapi::tbb::enumerable_thread_specific<WorkerState<StateFactory>>
+        for_each_with_state(std::vector<std::filesystem::path> const& files,
+                            StateFactory factory,
+                            StateProcessFun fun)
+        {
+            oneapi::tbb::enumerable_thread_specific<WorkerState<StateFactory>> states{
+                factory};
+            oneapi::tbb::parallel_for_each(
+                files.begin(),
+                files.end(),
+                [&states, fun](std::filesystem::path const& entry) {
+                    fun(states.local(), entry);
+                });
+
+            return states;
+        }
+
+        // Runs fun for a single file, recording any exception it throws as a failure
+        // for that file instead of letting it escape and cancel the remaining work.
+        template<typename Fun>
+        void run_isolated(std::filesystem::path const& path,
+                          Fun&& fun,
+                          oneapi::tbb::concurrent_vector<ProcessingFailure>& failures)
+        {
+            try
+            {
+                fun();
+            }
+            catch (cv::Exception const& e)
+            {
+                failures.push_back({.path = path.string(), .message = e.what()});
+            }
+            catch (std::exception const& e)
+            {
+                failures.push_back({.path = path.string(), .message = e.what()});
+            }
+            catch (...)
+            {
+                failures.push_back(
+                    {.path = path.string(), .message = "error: unknown exception"});
+            }
+        }
+
+        inline std::vector<ProcessingFailure>
+        sort_failures(oneapi::tbb::concurrent_vector<ProcessingFailure> const& failures)
+        {
+            std::vector<ProcessingFailure> result{failures.begin(), failures.end()};
+            std::ranges::sort(result, {}, &ProcessingFailure::path);
+            return result;
+        }
+
+        template<typename ProcessFun, typename... Args>
+        decltype(auto) invoke_process(ProcessFun& fun, Args&&... args)
+        {
+            const profiling::StageTimer timer{profiling::Stage::process};
+            return fun(std::forward<Args>(args)...);
+        }
+
+        inline std::pair<std::string, cv::Mat>
+        load_member(TarArchive const& archive, TarMember const& member, int flags)
+        {
+            return {std::filesystem::path{member.name}.stem().string(),
+                    decode_image(archive.data(member), member.size, flags)};
+        }
+
+        // Restores the result for entry from the cache if its contents have been seen
+        // before under the same version. Otherwise the image is decoded, processed and
+        // the returned result saved in the result directory and added to the cache.
+        // Files that can't be read are handed to the function as an empty image, the
+        // same as without a cache, and are never cached.
+        template<typename ImageProcessFun>
+        void process_cached(std::filesystem::path const& entry,
+                            ResultCache& cache,
+                            std::string const& result_root,
+                            std::string const& app_name,
+                            ImageProcessFun& fun,
+                            int flags)
+        {
+            // Results depend on how the image was decoded and on which app produced
+            // them, not just on the input file.
+            const auto context = app_name + ':' + std::to_string(flags);
+            std::optional<std::uint64_t> key;
+            try
+            {
+                key = cache.get_key(entry, context);
+            }
+            catch (std::runtime_error const&) // NOLINT(bugprone-empty-catch)
+            {}
+
+            const auto name        = entry.filename().string();
+            const auto destination = std::filesystem::path{result_root} / app_name / name;
+            if (key && cache.restore(*key, destination))
+            {
+                return;
+            }
+
+            auto [filename, img] = load_image(entry.string(), flags);
+            const cv::Mat result = invoke_process(fun, filename, img);
+            save_result(result, result_root, app_name, name);
+
+            // Empty results aren't saved, so anything at the destination was left there
+            // by an earlier run and doesn't belong under this key.
+            if (key && !result.empty() && std::filesystem::exists(destination))
+            {
+                cache.store(*key, destination);
+            }
+        }
+
+        inline auto make_path_source(std::vector<std::filesystem::path> const& files)
+        {
+            return [ite = files.begin(),
+                    end = files.end()]() mutable -> std::optional<std::filesystem::path> {
+                if (ite == end)
+                {
+                    return {};
+                }
+
+                return *ite++;
+            };
+        }
+
+        template<typename PathSource>
+        auto make_image_source_filter(PathSource& next_path)
+        {
+            return oneapi::tbb::make_filter<void, ImageToken>(
+                oneapi::tbb::filter_mode::serial_in_order,
+                [&next_path](oneapi::tbb::flow_control& fc) -> ImageToken {
+                    auto path = next_path();
+                    if (!path)
+                    {
+                        fc.stop();
+                        return {};
+                    }
+
+                    ImageToken token;
+                    token.path = std::move(*path);
+                    return token;
+                });
+        }
+
+        // Files that can't be read decode to an empty image, the same as they would
+        // through load_image, instead of tearing down the whole pipeline.
+        inline std::vector<std::uint8_t> read_file_bytes_or_empty(
+            std::filesystem::path const& path)
+        {
+            try
+            {
+                return read_file_bytes(path.string());
+            }
+            catch (std::runtime_error const&)
+            {
+                return {};
+            }
+        }
+
+        inline auto make_image_load_filter(int flags)
+        {
+            auto read = oneapi::tbb::make_filter<ImageToken, ImageToken>(
+                oneapi::tbb::filter_mode::parallel,
+                [](ImageToken token) {
+                    token.bytes = read_file_bytes_or_empty(token.path);
+                    return token;
+                });
+
+            auto decode = oneapi::tbb::make_filter<ImageToken, ImageToken>(
+                oneapi::tbb::filter_mode::parallel,
+                [flags](ImageToken token) {
+                    token.filename = token.path.stem().string();
+                    token.img      = decode_image(token.bytes, flags);
+                    token.bytes    = {};
+                    return token;
+                });
+
+            return read & decode;
+        }
+
+        inline std::size_t default_max_tokens()
+        {
+            return static_cast<std::size_t>(
+                       oneapi::tbb::this_task_arena::max_concurrency())
+                   * 2;
+        }
+
+        inline void validate_max_tokens(std::size_t max_tokens)
+        {
+            if (max_tokens == 0)
+            {
+                throw std::runtime_error{
+                    "error: the number of in-flight tokens must be greater than 0"};
+            }
+        }
+
+        template<typename PathSource, typename ImageProcessFun>
+        void run_image_pipeline(PathSource next_path,
+                                ImageProcessFun fun,
+                                std::size_t max_tokens,
+                                int flags)
+        {
+            validate_max_tokens(max_tokens);
+            oneapi::tbb::parallel_pipeline(
+                max_tokens,
+                make_image_source_filter(next_path) & make_image_load_filter(flags)
+                    & oneapi::tbb::make_filter<ImageToken, void>(
+                        oneapi::tbb::filter_mode::parallel,
+                        [fun](ImageToken token) {
+                            invoke_process(fun, token.filename, token.img);
+                        }));
+        }
+
+        // The sink stage is serial. With serial_in_order, TBB holds back results that
+        // finish early until everything before them has been sunk, so the in-flight
+        // tokens double as a bounded reorder buffer.
+        template<typename PathSource, typename ImageProcessFun, typename ResultSinkFun>
+        void run_image_pipeline(PathSource next_path,
+                                ImageProcessFun fun,
+                                ResultSinkFun sink,
+                                std::size_t max_tokens,
+                                int flags,
+                                oneapi::tbb::filter_mode sink_mode)
+        {
+            using ResultItem = std::pair<std::string, ImageResult<ImageProcessFun>>;
+
+            validate_max_tokens(max_tokens);
+            oneapi::tbb::parallel_pipeline(
+                max_tokens,
+                make_image_source_filter(next_path) & make_image_load_filter(flags)
+                    & oneapi::tbb::make_filter<ImageToken, ResultItem>(
+                        oneapi::tbb::filter_mode::parallel,
+                        [fun](ImageToken token) {
+                            auto result = invoke_process(fun, token.filename, token.img);
+                            return ResultItem{std::move(token.filename),
+                                              std::move(result)};
+                        })
+                    & oneapi::tbb::make_filter<ResultItem, void>(
+                        sink_mode,
+                        [&sink](ResultItem item) {
+                            sink(item.first, item.second);
+                        }));
+        }
+
+        inline std::vector<std::vector<std::filesystem::path>>
+        make_batches(std::vector<std::filesystem::path> const& files,
+                     std::size_t batch_size,
+                     PartialBatchPolicy policy)
+        {
+            if (batch_size == 0)
+            {
+                throw std::runtime_error{"error: batch size must be greater than 0"};
+            }
+
+            std::vector<std::vector<std::filesystem::path>> batches;
+            batches.reserve((files.size() + batch_size - 1) / batch_size);
+            for (std::size_t i{0}; i < files.size(); i += batch_size)
+            {
+                const std::size_t end = std::min(i + batch_size, files.size());
+                if (end - i < batch_size && policy == PartialBatchPolicy::drop)
+                {
+                    break;
+                }
+
+                batches.emplace_back(files.begin() + static_cast<std::ptrdiff_t>(i),
+                                     files.begin() + static_cast<std::ptrdiff_t>(end));
+            }
+
+            return batches;
+        }
+
+        // Loads a batch of images. If the batch is partial and the policy is set to
+        // pad, the images are padded with copies of the last image so the batch is
+        // always full. The names only ever contain the files that were loaded, so
+        // the number of padded entries is images.size() - names.size().
+        inline std::pair<std::vector<std::string>, std::vector<cv::Mat>>
+        load_batch(std::vector<std::filesystem::path> const& batch,
+                   std::size_t batch_size,
+                   int flags,
+                   PartialBatchPolicy policy)
+        {
+            std::vector<std::string> names;
+            std::vector<cv::Mat> images;
+            names.reserve(batch.size());
+            images.reserve(batch_size);
+            for (auto const& entry : batch)
+            {
+                auto [filename, img] = load_image(entry.string(), flags);
+                names.emplace_back(std::move(filename));
+                images.emplace_back(std::move(img));
+            }
+
+            if (policy == PartialBatchPolicy::pad && !images.empty())
+            {
+                images.resize(batch_size, images.back());
+            }
+
+            return {std::move(names), std::move(images)};
+        }
+
+        inline std::vector<std::filesystem::path>
+        remove_completed(std::vector<std::filesystem::path> const& files,
+                         CompletionManifest const& manifest)
+        {
+            std::vector<std::filesystem::path> remaining;
+            remaining.reserve(files.size());
+            for (auto const& entry : files)
+            {
+                if (!manifest.is_complete(entry.filename().string()))
+                {
+                    remaining.push_back(entry);
+                }
+            }
+
+            return remaining;
+        }
+
+        template<typename PathSource, typename FileProcessFun>
+        void run_file_pipeline(PathSource next_path,
+                               FileProcessFun fun,
+                               std::size_t max_tokens)
+        {
+            validate_max_tokens(max_tokens);
+            oneapi::tbb::parallel_pipeline(
+                max_tokens,
+                oneapi::tbb::make_filter<void, std::filesystem::path>(
+                    oneapi::tbb::filter_mode::serial_in_order,
+                    [&next_path](oneapi::tbb::flow_control& fc) {
+                        auto path = next_path();
+                        if (!path)
+                        {
+                            fc.stop();
+                            return std::filesystem::path{};
+                        }
+
+                        return std::move(*path);
+                    })
+                    & oneapi::tbb::make_filter<std::filesystem::path, void>(
+                        oneapi::tbb::filter_mode::parallel,
+                        [fun](std::filesystem::path const& path) {
+                            invoke_process(fun, path.string());
+                        }));
+        }
+
+        // Runs fun over the files, which returns the number of bytes it read. New
+        // files stop being scheduled as soon as the context is cancelled, but the
+        // ones already in flight are allowed to finish.
+        template<typename TrackedProcessFun>
+        void run_tracked_pipeline(std::vector<std::filesystem::path> const& files,
+                                  ProgressContext& progress,
+                                  TrackedProcessFun fun)
+        {
+            progress.start(files.size());
+            auto next_path = make_path_source(files);
+            try
+            {
+                oneapi::tbb::parallel_pipeline(
+                    default_max_tokens(),
+                    oneapi::tbb::make_filter<void, std::filesystem::path>(
+                        oneapi::tbb::filter_mode::serial_in_order,
+                        [&next_path, &progress](oneapi::tbb::flow_control& fc) {
+                            auto path = progress.is_cancelled()
+                                            ? std::optional<std::filesystem::path>{}
+                                            : next_path();
+                            if (!path)
+                            {
+                                fc.stop();
+                                return std::filesystem::path{};
+                            }
+
+                            return std::move(*path);
+                        })
+                        & oneapi::tbb::make_filter<std::filesystem::path, void>(
+                            oneapi::tbb::filter_mode::parallel,
+                            [fun, &progress](std::filesystem::path const& path) {
+                                try
+                                {
+                                    auto bytes_read = fun(path);
+                                    if (bytes_read)
+                                    {
+                                        progress.record_processed(*bytes_read);
+                                    }
+                                    else
+                                    {
+                                        progress.record_failed();
+                                    }
+                                }
+                                catch (...)
+                                {
+                                    progress.record_failed();
+                                    throw;
+                                }
+                            }));
+            }
+            catch (...)
+            {
+                // Report the final state even when fun fails, so anything waiting on the
+                // last callback isn't left hanging.
+                progress.finish();
+                throw;
+            }
+
+            progress.finish();
+        }
+
+        template<typename FileProcessFun, typename ResultSinkFun>
+        void run_ordered_file_pipeline(std::vector<std::filesystem::path> const& files,
+                                       FileProcessFun fun,
+                                       ResultSinkFun sink,
+                                       std::size_t max_tokens)
+        {
+            using ResultItem = std::pair<std::string, FileResult<FileProcessFun>>;
+
+            validate_max_tokens(max_tokens);
+            auto next_path = make_path_source(files);
+            oneapi::tbb::parallel_pipeline(
+                max_tokens,
+                oneapi::tbb::make_filter<void, std::string>(
+                    oneapi::tbb::filter_mode::serial_in_order,
+                    [&next_path](oneapi::tbb::flow_control& fc) {
+                        auto path = next_path();
+                        if (!path)
+                        {
+                            fc.stop();
+                            return std::string{};
+                        }
+
+                        return path->string();
+                    })
+                    & oneapi::tbb::make_filter<std::string, ResultItem>(
+                        oneapi::tbb::filter_mode::parallel,
+                        [fun](std::string path) {
+                            auto result = invoke_process(fun, path);
+                            return ResultItem{std::move(path), std::move(result)};
+                        })
+                    & oneapi::tbb::make_filter<ResultItem, void>(
+                        oneapi::tbb::filter_mode::serial_in_order,
+                        [&sink](ResultItem item) {
+                            sink(item.first, item.second);
+                        }));
+        }
+
+        inline auto make_frame_source_filter(VideoReader& reader)
+        {
+            return oneapi::tbb::make_filter<void, VideoFrame>(
+                oneapi::tbb::filter_mode::serial_in_order,
+                [&reader](oneapi::tbb::flow_control& fc) -> VideoFrame {
+                    auto frame = reader.next();
+                    if (!frame)
+                    {
+                        fc.stop();
+                        return {};
+                    }
+
+                    return std::move(*frame);
+                });
+        }
+
+        template<typename FrameProcessFun>
+        void run_video_pipeline(VideoReader& reader,
+                                FrameProcessFun fun,
+                                std::size_t max_tokens)
+        {
+            oneapi::tbb::parallel_pipeline(
+                max_tokens,
+                make_frame_source_filter(reader)
+                    & oneapi::tbb::make_filter<VideoFrame, void>(
+                        oneapi::tbb::filter_mode::parallel,
+                        [fun](VideoFrame frame) {
+                            invoke_process(fun, frame.index, frame.img);
+                        }));
+        }
+    } // namespace detail
+
     template<typename ImageProcessFun>
     void process_images(std::string const& root, ImageProcessFun fun, int flags)
     {
         for (auto const& entry : get_file_paths_from_root(root))
         {
             auto [filename, img] = load_image(entry.string(), flags);
-            fun(filename, img);
+            detail::invoke_process(fun, filename, img);
         }
     }
 
@@ -27,6 +574,148 @@ namespace rad
         process_images(root, fun, cv::IMREAD_COLOR);
     }
 
+    template<typename ImageProcessFun>
+    void process_images(std::string const& root,
+                        ImageProcessFun fun,
+                        int flags,
+                        ImageFilter const& filter)
+    {
+        for (auto const& entry : get_file_paths_from_root(root, filter))
+        {
+            auto [filename, img] = load_image(entry.string(), flags);
+            detail::invoke_process(fun, filename, img);
+        }
+    }
+
+    template<typename ImageProcessFun>
+    void process_images(std::string const& root,
+                        ImageProcessFun fun,
+                        int flags,
+                        ShardSpec const& shard)
+    {
+        auto files = select_shard(get_file_paths_from_root(root), root, shard);
+        for (auto const& entry : files)
+        {
+            auto [filename, img] = load_image(entry.string(), flags);
+            detail::invoke_process(fun, filename, img);
+        }
+    }
+
+    template<typename ImageProcessFun>
+    void process_images(std::string const& root,
+                        ImageProcessFun fun,
+                        int flags,
+                        ImageReadMode mode)
+    {
+        for (auto const& entry : get_file_paths_from_root(root))
+        {
+            auto [filename, img] = load_image(entry.string(), flags, mode);
+            detail::invoke_process(fun, filename, img);
+        }
+    }
+
+    // The images share their pixels with the cache, so they must be cloned before they
+    // are modified.
+    template<typename ImageProcessFun>
+    void process_images(std::string const& root,
+                        ImageProcessFun fun,
+                        int flags,
+                        ImageCache& cache)
+    {
+        for (auto const& entry : get_file_paths_from_root(root))
+        {
+            auto [filename, img] = load_image(entry.string(), flags, cache);
+            detail::invoke_process(fun, filename, img);
+        }
+    }
+
+    // The functor returns the result for each image, which is saved under the same
+    // name as the input in the result directory for app_name.
+    template<typename ImageProcessFun>
+    void process_images(std::string const& root,
+                        ResultCache& cache,
+                        std::string const& result_root,
+                        std::string const& app_name,
+                        ImageProcessFun fun,
+                        int flags)
+    {
+        create_result_dir(result_root, app_name);
+        for (auto const& entry : get_file_paths_from_root(root))
+        {
+            detail::process_cached(entry, cache, result_root, app_name, fun, flags);
+        }
+    }
+
+    template<typename ImageProcessFun>
+    void process_images(std::string const& root,
+                        ResultCache& cache,
+                        std::string const& result_root,
+                        std::string const& app_name,
+                        ImageProcessFun fun)
+    {
+        process_images(root, cache, result_root, app_name, fun, cv::IMREAD_COLOR);
+    }
+
+    // Members are decoded straight from the memory-mapped archive, so nothing is
+    // extracted to disk.
+    template<typename ImageProcessFun>
+    void process_images(TarArchive const& archive, ImageProcessFun fun, int flags)
+    {
+        for (auto const& member : archive.members())
+        {
+            auto [filename, img] = detail::load_member(archive, member, flags);
+            detail::invoke_process(fun, filename, img);
+        }
+    }
+
+    template<typename ImageProcessFun>
+    void process_images(TarArchive const& archive, ImageProcessFun fun)
+    {
+        process_images(archive, fun, cv::IMREAD_COLOR);
+    }
+
+    // The images are views into the mapped shard, so no decoding or copying is done.
+    template<typename ImageProcessFun>
+    void process_images(ImageShard const& shard, ImageProcessFun fun)
+    {
+        for (auto const& record : shard.records())
+        {
+            std::string filename = record.name;
+            cv::Mat img          = shard.image(record);
+            detail::invoke_process(fun, filename, img);
+        }
+    }
+
+    template<typename ImageProcessFun>
+    void process_images(std::string const& root,
+                        CompletionManifest& manifest,
+                        ImageProcessFun fun,
+                        int flags)
+    {
+        auto files = get_file_paths_from_root(root);
+        for (auto const& entry : detail::remove_completed(files, manifest))
+        {
+            auto [filename, img] = load_image(entry.string(), flags);
+            detail::invoke_process(fun, filename, img);
+
+            // Files that failed to decode are retried on the next run.
+            if (!img.empty())
+            {
+                manifest.mark_complete(entry.filename().string());
+            }
+        }
+
+        manifest.flush();
+    }
+
+    template<typename ImageProcessFun>
+    void process_images(std::string const& root,
+                        CompletionManifest& manifest,
+                        ImageProcessFun fun)
+    {
+        process_images(root, manifest, fun, cv::IMREAD_COLOR);
+    }
+
     template<typename ImageProcessFun>
     void process_images(std::string const& root,
                         std::vector<std::string> const& samples,
@@ -37,7 +726,7 @@ namespace rad
         {
             const std::string path = root + sample;
             auto [filename, img]   = load_image(path, flags);
-            fun(filename, img);
+            detail::invoke_process(fun, filename, img);
         }
     }
 
@@ -54,7 +743,7 @@ namespace rad
     {
         for (auto const& entry : get_file_paths_from_root(root))
         {
-            fun(entry.string());
+            detail::invoke_process(fun, entry.string());
         }
     }
 
@@ -66,7 +755,7 @@ namespace rad
         for (auto sample : samples)
         {
             std::string path = root + sample;
-            fun(path);
+            detail::invoke_process(fun, path);
         }
     }
 
@@ -81,7 +770,7 @@ namespace rad
                                        [fun, flags](std::filesystem::path const& entry) {
                                            auto [filename, img] =
                                                load_image(entry.string(), flags);
-                                           fun(filename, img);
+                                           detail::invoke_process(fun, filename, img);
                                        });
     }
 
@@ -93,51 +782,1063 @@ namespace rad
 
     template<typename ImageProcessFun>
     void process_images_parallel(std::string const& root,
-                                 std::vector<std::string> const& samples,
                                  ImageProcessFun fun,
-                                 int flags)
+                                 int flags,
+                                 ShardSpec const& shard)
     {
-        oneapi::tbb::parallel_for_each(samples.begin(),
-                                       samples.end(),
-                                       [fun, root, flags](std::string const& sample) {
-                                           const std::string path = root + sample;
-                                           auto [filename, img] = load_image(path, flags);
-                                           fun(filename, img);
-                                       });
+        auto files = select_shard(get_file_paths_from_root(root), root, shard);
+        oneapi::tbb::parallel_for_each(
+            files.begin(),
+            files.end(),
+            [fun, flags](std::filesystem::path const& entry) {
+                auto [filename, img] = load_image(entry.string(), flags);
+                detail::invoke_process(fun, filename, img);
+            });
     }
 
     template<typename ImageProcessFun>
     void process_images_parallel(std::string const& root,
-                                 std::vector<std::string> const& samples,
+                                 ImageProcessFun fun,
+                                 int flags,
+                                 oneapi::tbb::task_arena& arena)
+    {
+        arena.execute([&root, &fun, flags] {
+            process_images_parallel(root, fun, flags);
+        });
+    }
+
+    template<typename ImageProcessFun>
+    void process_images_parallel(std::string const& root,
+                                 ImageProcessFun fun,
+                                 int flags,
+                                 WorkerArena& arena)
+    {
+        process_images_parallel(root, fun, flags, arena.get());
+    }
+
+    template<typename StateFactory, typename ImageProcessFun>
+    requires std::invocable<StateFactory&>
+             && std::invocable<ImageProcessFun&,
+                               detail::WorkerState<StateFactory>&,
+                               std::string&,
+                               cv::Mat&>
+    void process_images_parallel(std::string const& root,
+                                 StateFactory factory,
+                                 ImageProcessFun fun,
+                                 int flags)
+    {
+        auto files = get_file_paths_from_root(root);
+        detail::for_each_with_state(
+            files,
+            factory,
+            [fun, flags](auto& state, std::filesystem::path const& entry) {
+                auto [filename, img] = load_image(entry.string(), flags);
+                detail::invoke_process(fun, state, filename, img);
+            });
+    }
+
+    template<typename StateFactory, typename ImageProcessFun>
+    requires std::invocable<StateFactory&>
+             && std::invocable<ImageProcessFun&,
+                               detail::WorkerState<StateFactory>&,
+                               std::string&,
+                               cv::Mat&>
+    void process_images_parallel(std::string const& root,
+                                 StateFactory factory,
                                  ImageProcessFun fun)
     {
-        process_images_parallel(root, samples, fun, cv::IMREAD_COLOR);
+        process_images_parallel(root, factory, fun, cv::IMREAD_COLOR);
     }
 
-    template<typename FileProcessFun>
-    void process_files_parallel(std::string const& root, FileProcessFun fun)
+    template<typename StateFactory, typename ImageProcessFun, typename CombineFun>
+    requires std::invocable<StateFactory&>
+             && std::invocable<ImageProcessFun&,
+                               detail::WorkerState<StateFactory>&,
+                               std::string&,
+                               cv::Mat&>
+             && std::invocable<CombineFun&,
+                               detail::WorkerState<StateFactory> const&,
+                               detail::WorkerState<StateFactory> const&>
+    detail::WorkerState<StateFactory> process_images_parallel(std::string const& root,
+                                                              StateFactory factory,
+                                                              ImageProcessFun fun,
+                                                              CombineFun combine,
+                                                              int flags)
+    {
+        auto files  = get_file_paths_from_root(root);
+        auto states = detail::for_each_with_state(
+            files,
+            factory,
+            [fun, flags](auto& state, std::filesystem::path const& entry) {
+                auto [filename, img] = load_image(entry.string(), flags);
+                detail::invoke_process(fun, state, filename, img);
+            });
+
+        return states.combine(combine);
+    }
+
+    template<typename StateFactory, typename ImageProcessFun, typename CombineFun>
+    requires std::invocable<StateFactory&>
+             && std::invocable<ImageProcessFun&,
+                               detail::WorkerState<StateFactory>&,
+                               std::string&,
+                               cv::Mat&>
+             && std::invocable<CombineFun&,
+                               detail::WorkerState<StateFactory> const&,
+                               detail::WorkerState<StateFactory> const&>
+    detail::WorkerState<StateFactory> process_images_parallel(std::string const& root,
+                                                              StateFactory factory,
+                                                              ImageProcessFun fun,
+                                                              CombineFun combine)
+    {
+        return process_images_parallel(root, factory, fun, combine, cv::IMREAD_COLOR);
+    }
+
+    template<typename ImageProcessFun>
+    void process_images_parallel(std::string const& root,
+                                 ImageProcessFun fun,
+                                 int flags,
+                                 ImageReadMode mode)
     {
         auto files = get_file_paths_from_root(root);
-        const std::filesystem::directory_iterator ite{root};
-        oneapi::tbb::parallel_for_each(files.begin(),
-                                       files.end(),
-                                       [fun](std::filesystem::path const& entry) {
-                                           fun(entry.string());
-                                       });
+        oneapi::tbb::parallel_for_each(
+            files.begin(),
+            files.end(),
+            [fun, flags, mode](std::filesystem::path const& entry) {
+                auto [filename, img] = load_image(entry.string(), flags, mode);
+                detail::invoke_process(fun, filename, img);
+            });
     }
 
-    template<typename FileProcessFun>
-    void process_files_parallel(std::string const& root,
-                                std::vector<std::string> const& samples,
-                                FileProcessFun fun)
+    template<typename ImageProcessFun>
+    void process_images_parallel(std::string const& root,
+                                 ImageProcessFun fun,
+                                 int flags,
+                                 ImageCache& cache)
     {
-        oneapi::tbb::parallel_for_each(samples.begin(),
-                                       samples.end(),
-                                       [fun, root](std::string const& sample) {
-                                           const std::string path = root + sample;
-                                           auto [filename, img]   = load_image(path);
-                                           fun(filename, img);
-                                       });
+        auto files = get_file_paths_from_root(root);
+        oneapi::tbb::parallel_for_each(
+            files.begin(),
+            files.end(),
+            [fun, flags, &cache](std::filesystem::path const& entry) {
+                auto [filename, img] = load_image(entry.string(), flags, cache);
+                detail::invoke_process(fun, filename, img);
+            });
     }
 
+    template<typename ImageProcessFun>
+    void process_images_parallel(std::string const& root,
+                                 ImageProcessFun fun,
+                                 int flags,
+                                 SchedulingPolicy policy)
+    {
+        switch (policy)
+        {
+        case SchedulingPolicy::directory_order:
+            process_images_parallel(root, fun, flags);
+            break;
+
+        case SchedulingPolicy::largest_first:
+        {
+            // The pipeline hands out files strictly in order, so the largest files
+            // are always picked up first by whichever worker is free.
+            auto files = sort_by_file_size(get_file_paths_from_root(root));
+            detail::run_image_pipeline(detail::make_path_source(files),
+                                       fun,
+                                       detail::default_max_tokens(),
+                                       flags);
+            break;
+        }
+
+        case SchedulingPolicy::balanced:
+        {
+            const auto num_chunks =
+                static_cast<std::size_t>(oneapi::tbb::this_task_arena::max_concurrency())
+                * 4;
+            auto chunks =
+                partition_by_file_size(get_file_paths_from_root(root), num_chunks);
+            oneapi::tbb::parallel_for_each(
+                chunks.begin(),
+                chunks.end(),
+                [fun, flags](std::vector<std::filesystem::path> const& chunk) {
+                    for (auto const& entry : chunk)
+                    {
+                        auto [filename, img] = load_image(entry.string(), flags);
+                        detail::invoke_process(fun, filename, img);
+                    }
+                });
+            break;
+        }
+        }
+    }
+
+    template<typename ImageProcessFun>
+    void process_images_parallel(std::string const& root,
+                                 ImageProcessFun fun,
+                                 int flags,
+                                 MemoryBudget& budget)
+    {
+        using Item = std::pair<std::filesystem::path, MemoryBudget::Reservation>;
+
+        auto files     = get_file_paths_from_root(root);
+        auto next_path = detail::make_path_source(files);
+
+        // Admission happens in the serial input stage, so at most one thread is ever
+        // blocked waiting on the budget while the rest keep draining the pipeline.
+        // The reservation is released once the item leaves the last stage.
+        oneapi::tbb::parallel_pipeline(
+            detail::default_max_tokens(),
+            oneapi::tbb::make_filter<void, Item>(
+                oneapi::tbb::filter_mode::serial_in_order,
+                [&next_path, &budget, flags](oneapi::tbb::flow_control& fc) -> Item {
+                    auto path = next_path();
+                    if (!path)
+                    {
+                        fc.stop();
+                        return {};
+                    }
+
+                    auto bytes = estimate_decoded_size(*path, flags);
+                    return {std::move(*path), budget.reserve(bytes)};
+                })
+                & oneapi::tbb::make_filter<Item, void>(
+                    oneapi::tbb::filter_mode::parallel,
+                    [fun, flags](Item item) {
+                        auto [filename, img] = load_image(item.first.string(), flags);
+                        detail::invoke_process(fun, filename, img);
+                    }));
+    }
+
+    template<typename ImageProcessFun>
+    void process_images_parallel(std::string const& root,
+                                 ImageProcessFun fun,
+                                 int flags,
+                                 ImageFilter const& filter)
+    {
+        auto files = get_file_paths_from_root(root, filter);
+        oneapi::tbb::parallel_for_each(files.begin(),
+                                       files.end(),
+                                       [fun, flags](std::filesystem::path const& entry) {
+                                           auto [filename, img] =
+                                               load_image(entry.string(), flags);
+                                           detail::invoke_process(fun, filename, img);
+                                       });
+    }
+
+    template<typename ImageProcessFun>
+    void process_images_parallel(ImageShard const& shard, ImageProcessFun fun)
+    {
+        auto const& records = shard.records();
+        oneapi::tbb::parallel_for_each(records.begin(),
+                                       records.end(),
+                                       [&shard, fun](ShardRecord const& record) {
+                                           std::string filename = record.name;
+                                           cv::Mat img          = shard.image(record);
+                                           detail::invoke_process(fun, filename, img);
+                                       });
+    }
+
+    template<typename ImageProcessFun>
+    void
+    process_images_parallel(TarArchive const& archive, ImageProcessFun fun, int flags)
+    {
+        auto const& members = archive.members();
+        oneapi::tbb::parallel_for_each(
+            members.begin(),
+            members.end(),
+            [&archive, fun, flags](TarMember const& member) {
+                auto [filename, img] = detail::load_member(archive, member, flags);
+                detail::invoke_process(fun, filename, img);
+            });
+    }
+
+    template<typename ImageProcessFun>
+    void process_images_parallel(TarArchive const& archive, ImageProcessFun fun)
+    {
+        process_images_parallel(archive, fun, cv::IMREAD_COLOR);
+    }
+
+    template<typename ImageProcessFun>
+    void process_images_parallel(std::string const& root,
+                                 ResultCache& cache,
+                                 std::string const& result_root,
+                                 std::string const& app_name,
+                                 ImageProcessFun fun,
+                                 int flags)
+    {
+        create_result_dir(result_root, app_name);
+        auto files = get_file_paths_from_root(root);
+        oneapi::tbb::parallel_for_each(
+            files.begin(),
+            files.end(),
+            [&cache, &result_root, &app_name, fun, flags](
+                std::filesystem::path const& entry) {
+                detail::process_cached(entry, cache, result_root, app_name, fun, flags);
+            });
+    }
+
+    template<typename ImageProcessFun>
+    void process_images_parallel(std::string const& root,
+                                 ResultCache& cache,
+                                 std::string const& result_root,
+                                 std::string const& app_name,
+                                 ImageProcessFun fun)
+    {
+        process_images_parallel(root,
+                                cache,
+                                result_root,
+                                app_name,
+                                fun,
+                                cv::IMREAD_COLOR);
+    }
+
+    template<typename ImageProcessFun>
+    void process_images_parallel(std::string const& root,
+                                 CompletionManifest& manifest,
+                                 ImageProcessFun fun,
+                                 int flags)
+    {
+        auto files = detail::remove_completed(get_file_paths_from_root(root), manifest);
+        oneapi::tbb::parallel_for_each(
+            files.begin(),
+            files.end(),
+            [fun, flags, &manifest](std::filesystem::path const& entry) {
+                auto [filename, img] = load_image(entry.string(), flags);
+                detail::invoke_process(fun, filename, img);
+                if (!img.empty())
+                {
+                    manifest.mark_complete(entry.filename().string());
+                }
+            });
+
+        manifest.flush();
+    }
+
+    template<typename ImageProcessFun>
+    void process_images_parallel(std::string const& root,
+                                 CompletionManifest& manifest,
+                                 ImageProcessFun fun)
+    {
+        process_images_parallel(root, manifest, fun, cv::IMREAD_COLOR);
+    }
+
+    template<typename ImageProcessFun>
+    void process_images_parallel(std::string const& root,
+                                 ProgressContext& progress,
+                                 ImageProcessFun fun,
+                                 int flags)
+    {
+        auto files = get_file_paths_from_root(root);
+        detail::run_tracked_pipeline(
+            files,
+            progress,
+            [fun, flags](
+                std::filesystem::path const& path) -> std::optional<std::uint64_t> {
+                auto bytes    = detail::read_file_bytes_or_empty(path);
+                auto filename = path.stem().string();
+                auto img      = decode_image(bytes, flags);
+                detail::invoke_process(fun, filename, img);
+                if (img.empty())
+                {
+                    return {};
+                }
+
+                return bytes.size();
+            });
+    }
+
+    template<typename ImageProcessFun>
+    void process_images_parallel(std::string const& root,
+                                 ProgressContext& progress,
+                                 ImageProcessFun fun)
+    {
+        process_images_parallel(root, progress, fun, cv::IMREAD_COLOR);
+    }
+
+    template<typename ImageProcessFun>
+    void process_images_parallel(std::string const& root,
+                                 std::vector<std::string> const& samples,
+                                 ImageProcessFun fun,
+                                 int flags)
+    {
+        oneapi::tbb::parallel_for_each(samples.begin(),
+                                       samples.end(),
+                                       [fun, root, flags](std::string const& sample) {
+                                           const std::string path = root + sample;
+                                           auto [filename, img] = load_image(path, flags);
+                                           detail::invoke_process(fun, filename, img);
+                                       });
+    }
+
+    template<typename ImageProcessFun>
+    void process_images_parallel(std::string const& root,
+                                 std::vector<std::string> const& samples,
+                                 ImageProcessFun fun)
+    {
+        process_images_parallel(root, samples, fun, cv::IMREAD_COLOR);
+    }
+
+    template<typename FileProcessFun>
+    void process_files_parallel(std::string const& root, FileProcessFun fun)
+    {
+        auto files = get_file_paths_from_root(root);
+        const std::filesystem::directory_iterator ite{root};
+        oneapi::tbb::parallel_for_each(files.begin(),
+                                       files.end(),
+                                       [fun](std::filesystem::path const& entry) {
+                                           detail::invoke_process(fun, entry.string());
+                                       });
+    }
+
+    template<typename FileProcessFun>
+    void process_files_parallel(std::string const& root,
+                                FileProcessFun fun,
+                                oneapi::tbb::task_arena& arena)
+    {
+        arena.execute([&root, &fun] {
+            process_files_parallel(root, fun);
+        });
+    }
+
+    template<typename FileProcessFun>
+    void process_files_parallel(std::string const& root,
+                                FileProcessFun fun,
+                                WorkerArena& arena)
+    {
+        process_files_parallel(root, fun, arena.get());
+    }
+
+    template<typename StateFactory, typename FileProcessFun>
+    requires std::invocable<StateFactory&>
+             && std::invocable<FileProcessFun&,
+                               detail::WorkerState<StateFactory>&,
+                               std::string const&>
+    void process_files_parallel(std::string const& root,
+                                StateFactory factory,
+                                FileProcessFun fun)
+    {
+        auto files = get_file_paths_from_root(root);
+        detail::for_each_with_state(
+            files,
+            factory,
+            [fun](auto& state, std::filesystem::path const& entry) {
+                detail::invoke_process(fun, state, entry.string());
+            });
+    }
+
+    template<typename StateFactory, typename FileProcessFun, typename CombineFun>
+    requires std::invocable<StateFactory&>
+             && std::invocable<FileProcessFun&,
+                               detail::WorkerState<StateFactory>&,
+                               std::string const&>
+             && std::invocable<CombineFun&,
+                               detail::WorkerState<StateFactory> const&,
+                               detail::WorkerState<StateFactory> const&>
+    detail::WorkerState<StateFactory> process_files_parallel(std::string const& root,
+                                                             StateFactory factory,
+                                                             FileProcessFun fun,
+                                                             CombineFun combine)
+    {
+        auto files  = get_file_paths_from_root(root);
+        auto states = detail::for_each_with_state(
+            files,
+            factory,
+            [fun](auto& state, std::filesystem::path const& entry) {
+                detail::invoke_process(fun, state, entry.string());
+            });
+
+        return states.combine(combine);
+    }
+
+    template<typename FileProcessFun>
+    void process_files_parallel(std::string const& root,
+                                FileProcessFun fun,
+                                ShardSpec const& shard)
+    {
+        auto files = select_shard(get_file_paths_from_root(root), root, shard);
+        oneapi::tbb::parallel_for_each(files.begin(),
+                                       files.end(),
+                                       [fun](std::filesystem::path const& entry) {
+                                           detail::invoke_process(fun, entry.string());
+                                       });
+    }
+
+    template<typename FileProcessFun>
+    void process_files_parallel(std::string const& root,
+                                ProgressContext& progress,
+                                FileProcessFun fun)
+    {
+        auto files = get_file_paths_from_root(root);
+        detail::run_tracked_pipeline(
+            files,
+            progress,
+            [fun](std::filesystem::path const& path) -> std::optional<std::uint64_t> {
+                detail::invoke_process(fun, path.string());
+                return std::uint64_t{0};
+            });
+    }
+
+    template<typename FileProcessFun>
+    void process_files_parallel(std::string const& root,
+                                std::vector<std::string> const& samples,
+                                FileProcessFun fun)
+    {
+        oneapi::tbb::parallel_for_each(samples.begin(),
+                                       samples.end(),
+                                       [fun, root](std::string const& sample) {
+                                           const std::string path = root + sample;
+                                           auto [filename, img]   = load_image(path);
+                                           detail::invoke_process(fun, filename, img);
+                                       });
+    }
+
+    template<typename ImageProcessFun>
+    std::vector<ProcessingFailure>
+    process_images_parallel_safe(std::string const& root, ImageProcessFun fun, int flags)
+    {
+        auto files = get_file_paths_from_root(root);
+        oneapi::tbb::concurrent_vector<ProcessingFailure> failures;
+        oneapi::tbb::parallel_for_each(
+            files.begin(),
+            files.end(),
+            [fun, flags, &failures](std::filesystem::path const& entry) {
+                detail::run_isolated(
+                    entry,
+                    [&fun, &entry, flags] {
+                        auto [filename, img] = load_image(entry.string(), flags);
+                        detail::invoke_process(fun, filename, img);
+                    },
+                    failures);
+            });
+
+        return detail::sort_failures(failures);
+    }
+
+    template<typename ImageProcessFun>
+    std::vector<ProcessingFailure> process_images_parallel_safe(std::string const& root,
+                                                                ImageProcessFun fun)
+    {
+        return process_images_parallel_safe(root, fun, cv::IMREAD_COLOR);
+    }
+
+    template<typename FileProcessFun>
+    std::vector<ProcessingFailure> process_files_parallel_safe(std::string const& root,
+                                                               FileProcessFun fun)
+    {
+        auto files = get_file_paths_from_root(root);
+        oneapi::tbb::concurrent_vector<ProcessingFailure> failures;
+        oneapi::tbb::parallel_for_each(
+            files.begin(),
+            files.end(),
+            [fun, &failures](std::filesystem::path const& entry) {
+                detail::run_isolated(
+                    entry,
+                    [&fun, &entry] {
+                        detail::invoke_process(fun, entry.string());
+                    },
+                    failures);
+            });
+
+        return detail::sort_failures(failures);
+    }
+
+    // Maps every image to a value and folds the values together with combine_fun, which
+    // must be associative. Each worker accumulates its own partial result starting
+    // from identity, so no state is shared while the images are being processed.
+    template<typename T, typename ImageMapFun, typename CombineFun>
+    T process_images_reduce(std::string const& root,
+                            T identity,
+                            ImageMapFun map_fun,
+                            CombineFun combine_fun,
+                            int flags)
+    {
+        auto files = get_file_paths_from_root(root);
+        return oneapi::tbb::parallel_reduce(
+            oneapi::tbb::blocked_range<std::size_t>{0, files.size()},
+            identity,
+            [&files, &map_fun, &combine_fun, flags](
+                oneapi::tbb::blocked_range<std::size_t> const& range, T partial) {
+                for (auto i = range.begin(); i != range.end(); ++i)
+                {
+                    auto [filename, img] = load_image(files[i].string(), flags);
+                    auto value = detail::invoke_process(map_fun, filename, img);
+                    partial    = combine_fun(std::move(partial), std::move(value));
+                }
+
+                return partial;
+            },
+            combine_fun);
+    }
+
+    template<typename T, typename ImageMapFun, typename CombineFun>
+    T process_images_reduce(std::string const& root,
+                            T identity,
+                            ImageMapFun map_fun,
+                            CombineFun combine_fun)
+    {
+        return process_images_reduce(root,
+                                     std::move(identity),
+                                     map_fun,
+                                     combine_fun,
+                                     cv::IMREAD_COLOR);
+    }
+
+    template<typename T, typename FileMapFun, typename CombineFun>
+    T process_files_reduce(std::string const& root,
+                           T identity,
+                           FileMapFun map_fun,
+                           CombineFun combine_fun)
+    {
+        auto files = get_file_paths_from_root(root);
+        return oneapi::tbb::parallel_reduce(
+            oneapi::tbb::blocked_range<std::size_t>{0, files.size()},
+            identity,
+            [&files, &map_fun, &combine_fun](
+                oneapi::tbb::blocked_range<std::size_t> const& range, T partial) {
+                for (auto i = range.begin(); i != range.end(); ++i)
+                {
+                    auto value = detail::invoke_process(map_fun, files[i].string());
+                    partial    = combine_fun(std::move(partial), std::move(value));
+                }
+
+                return partial;
+            },
+            combine_fun);
+    }
+
+    // Runs fun(tile, img) over the tiles of a raw raster in parallel. The tiles are
+    // views into the memory-mapped file, so only the tiles that are currently being
+    // processed need to be resident.
+    template<typename TileProcessFun>
+    void process_raster_tiled(std::string const& path,
+                              RasterLayout const& layout,
+                              cv::Size tile_size,
+                              int overlap,
+                              TileProcessFun fun)
+    {
+        const RawRasterReader reader{path, layout};
+        auto tiles = make_tiles(layout.size, tile_size, overlap);
+        oneapi::tbb::parallel_for_each(tiles.begin(),
+                                       tiles.end(),
+                                       [&reader, fun](TileSpec const& tile) {
+                                           const cv::Mat img = reader.read(tile.roi);
+                                           detail::invoke_process(fun, tile, img);
+                                       });
+    }
+
+    // As above, but fun returns a cv::Mat of output_type with the same size as the tile
+    // it was given. The core of every result is written to a raw raster at output with
+    // the same dimensions as the input.
+    template<typename TileProcessFun>
+    void process_raster_tiled(std::string const& path,
+                              RasterLayout const& layout,
+                              cv::Size tile_size,
+                              int overlap,
+                              std::string const& output,
+                              int output_type,
+                              TileProcessFun fun)
+    {
+        const RawRasterReader reader{path, layout};
+        RawRasterWriter writer{output, {.size = layout.size, .type = output_type}};
+        auto tiles = make_tiles(layout.size, tile_size, overlap);
+        oneapi::tbb::parallel_for_each(
+            tiles.begin(),
+            tiles.end(),
+            [&reader, &writer, fun](TileSpec const& tile) {
+                const cv::Mat img    = reader.read(tile.roi);
+                const cv::Mat result = detail::invoke_process(fun, tile, img);
+                const profiling::StageTimer timer{profiling::Stage::save};
+                writer.write_tile(tile, result);
+            });
+        writer.flush();
+    }
+
+    template<typename ImageProcessFun>
+    void process_images_pipelined(std::string const& root,
+                                  ImageProcessFun fun,
+                                  std::size_t max_tokens,
+                                  int flags)
+    {
+        auto files = get_file_paths_from_root(root);
+        detail::run_image_pipeline(detail::make_path_source(files),
+                                   fun,
+                                   max_tokens,
+                                   flags);
+    }
+
+    template<typename ImageProcessFun>
+    void process_images_pipelined(std::string const& root,
+                                  ImageProcessFun fun,
+                                  std::size_t max_tokens)
+    {
+        process_images_pipelined(root, fun, max_tokens, cv::IMREAD_COLOR);
+    }
+
+    template<typename ImageProcessFun, typename ResultSinkFun>
+    requires std::invocable<ResultSinkFun&,
+                            std::string const&,
+                            detail::ImageResult<ImageProcessFun>&>
+    void process_images_pipelined(std::string const& root,
+                                  ImageProcessFun fun,
+                                  ResultSinkFun sink,
+                                  std::size_t max_tokens,
+                                  int flags)
+    {
+        auto files = get_file_paths_from_root(root);
+        detail::run_image_pipeline(detail::make_path_source(files),
+                                   fun,
+                                   sink,
+                                   max_tokens,
+                                   flags,
+                                   oneapi::tbb::filter_mode::serial_out_of_order);
+    }
+
+    template<typename ImageProcessFun, typename ResultSinkFun>
+    requires std::invocable<ResultSinkFun&,
+                            std::string const&,
+                            detail::ImageResult<ImageProcessFun>&>
+    void process_images_pipelined(std::string const& root,
+                                  ImageProcessFun fun,
+                                  ResultSinkFun sink,
+                                  std::size_t max_tokens)
+    {
+        process_images_pipelined(root, fun, sink, max_tokens, cv::IMREAD_COLOR);
+    }
+
+    template<typename ImageProcessFun, typename ResultSinkFun>
+    requires std::invocable<ResultSinkFun&,
+                            std::string const&,
+                            detail::ImageResult<ImageProcessFun>&>
+    void process_images_ordered(std::string const& root,
+                                ImageProcessFun fun,
+                                ResultSinkFun sink,
+                                std::size_t max_tokens,
+                                int flags)
+    {
+        auto files = get_file_paths_from_root(root);
+        detail::run_image_pipeline(detail::make_path_source(files),
+                                   fun,
+                                   sink,
+                                   max_tokens,
+                                   flags,
+                                   oneapi::tbb::filter_mode::serial_in_order);
+    }
+
+    template<typename ImageProcessFun, typename ResultSinkFun>
+    requires std::invocable<ResultSinkFun&,
+                            std::string const&,
+                            detail::ImageResult<ImageProcessFun>&>
+    void process_images_ordered(std::string const& root,
+                                ImageProcessFun fun,
+                                ResultSinkFun sink,
+                                std::size_t max_tokens)
+    {
+        process_images_ordered(root, fun, sink, max_tokens, cv::IMREAD_COLOR);
+    }
+
+    template<typename ImageProcessFun, typename ResultSinkFun>
+    requires std::invocable<ResultSinkFun&,
+                            std::string const&,
+                            detail::ImageResult<ImageProcessFun>&>
+    void process_images_ordered(std::string const& root,
+                                ImageProcessFun fun,
+                                ResultSinkFun sink)
+    {
+        process_images_ordered(root, fun, sink, detail::default_max_tokens());
+    }
+
+    template<typename FileProcessFun, typename ResultSinkFun>
+    requires std::invocable<ResultSinkFun&,
+                            std::string const&,
+                            detail::FileResult<FileProcessFun>&>
+    void process_files_ordered(std::string const& root,
+                               FileProcessFun fun,
+                               ResultSinkFun sink,
+                               std::size_t max_tokens)
+    {
+        auto files = get_file_paths_from_root(root);
+        detail::run_ordered_file_pipeline(files, fun, sink, max_tokens);
+    }
+
+    template<typename FileProcessFun, typename ResultSinkFun>
+    requires std::invocable<ResultSinkFun&,
+                            std::string const&,
+                            detail::FileResult<FileProcessFun>&>
+    void process_files_ordered(std::string const& root,
+                               FileProcessFun fun,
+                               ResultSinkFun sink)
+    {
+        process_files_ordered(root, fun, sink, detail::default_max_tokens());
+    }
+
+    template<typename ImageProcessFun>
+    void process_images_prefetched(std::string const& root,
+                                   ImageProcessFun fun,
+                                   std::size_t window,
+                                   int flags)
+    {
+        PrefetchReader reader{get_file_paths_from_root(root), window};
+        oneapi::tbb::parallel_pipeline(
+            window,
+            oneapi::tbb::make_filter<void, FileBuffer>(
+                oneapi::tbb::filter_mode::serial_in_order,
+                [&reader](oneapi::tbb::flow_control& fc) -> FileBuffer {
+                    auto buffer = reader.next();
+                    if (!buffer)
+                    {
+                        fc.stop();
+                        return {};
+                    }
+
+                    return std::move(*buffer);
+                })
+                & oneapi::tbb::make_filter<FileBuffer, void>(
+                    oneapi::tbb::filter_mode::parallel,
+                    [fun, flags](FileBuffer buffer) {
+                        auto filename = buffer.path.stem().string();
+                        auto img      = decode_image(buffer.bytes, flags);
+                        buffer.bytes  = {};
+                        detail::invoke_process(fun, filename, img);
+                    }));
+    }
+
+    template<typename ImageProcessFun>
+    void process_images_prefetched(std::string const& root,
+                                   ImageProcessFun fun,
+                                   std::size_t window)
+    {
+        process_images_prefetched(root, fun, window, cv::IMREAD_COLOR);
+    }
+
+    template<typename FrameProcessFun>
+    void process_video(std::string const& path, FrameProcessFun fun)
+    {
+        cv::VideoCapture capture{path};
+        if (!capture.isOpened())
+        {
+            throw std::runtime_error{fmt::format("error: unable to open video {}", path)};
+        }
+
+        cv::Mat frame;
+        for (std::size_t index{0}; capture.read(frame) && !frame.empty(); ++index)
+        {
+            detail::invoke_process(fun, index, frame);
+        }
+    }
+
+    template<typename FrameProcessFun>
+    void process_video_parallel(std::string const& path,
+                                FrameProcessFun fun,
+                                std::size_t ring_size)
+    {
+        VideoReader reader{path, ring_size};
+        detail::run_video_pipeline(reader, fun, detail::default_max_tokens());
+    }
+
+    template<typename FrameProcessFun>
+    void process_video_parallel(std::string const& path, FrameProcessFun fun)
+    {
+        process_video_parallel(path, fun, VideoReader::default_ring_size);
+    }
+
+    template<typename FrameProcessFun, typename ResultSinkFun>
+    requires std::invocable<ResultSinkFun&,
+                            std::size_t,
+                            detail::FrameResult<FrameProcessFun>&>
+    void process_video_parallel(std::string const& path,
+                                FrameProcessFun fun,
+                                ResultSinkFun sink,
+                                std::size_t ring_size)
+    {
+        using ResultItem = std::pair<std::size_t, detail::FrameResult<FrameProcessFun>>;
+
+        VideoReader reader{path, ring_size};
+        oneapi::tbb::parallel_pipeline(
+            detail::default_max_tokens(),
+            detail::make_frame_source_filter(reader)
+                & oneapi::tbb::make_filter<VideoFrame, ResultItem>(
+                    oneapi::tbb::filter_mode::parallel,
+                    [fun](VideoFrame frame) {
+                        auto result = detail::invoke_process(fun, frame.index, frame.img);
+                        return ResultItem{frame.index, std::move(result)};
+                    })
+                & oneapi::tbb::make_filter<ResultItem, void>(
+                    oneapi::tbb::filter_mode::serial_in_order,
+                    [&sink](ResultItem item) {
+                        sink(item.first, item.second);
+                    }));
+    }
+
+    template<typename FrameProcessFun, typename ResultSinkFun>
+    requires std::invocable<ResultSinkFun&,
+                            std::size_t,
+                            detail::FrameResult<FrameProcessFun>&>
+    void process_video_parallel(std::string const& path,
+                                FrameProcessFun fun,
+                                ResultSinkFun sink)
+    {
+        process_video_parallel(path, fun, sink, VideoReader::default_ring_size);
+    }
+
+    // Each video gets its own decode thread, but the frames from all of them are
+    // processed by the same TBB worker pool.
+    template<typename VideoProcessFun>
+    void process_videos_parallel(std::vector<std::string> const& paths,
+                                 VideoProcessFun fun,
+                                 std::size_t ring_size)
+    {
+        oneapi::tbb::parallel_for_each(
+            paths.begin(),
+            paths.end(),
+            [fun, ring_size](std::string const& path) {
+                const auto name = std::filesystem::path{path}.stem().string();
+                VideoReader reader{path, ring_size};
+                detail::run_video_pipeline(
+                    reader,
+                    [fun, &name](std::size_t index, cv::Mat& frame) {
+                        fun(name, index, frame);
+                    },
+                    detail::default_max_tokens());
+            });
+    }
+
+    template<typename VideoProcessFun>
+    void process_videos_parallel(std::vector<std::string> const& paths,
+                                 VideoProcessFun fun)
+    {
+        process_videos_parallel(paths, fun, VideoReader::default_ring_size);
+    }
+
+    template<typename ImageProcessFun>
+    void process_images_recursive(std::string const& root, ImageProcessFun fun, int flags)
+    {
+        FileStream stream{root};
+        while (auto entry = stream.next())
+        {
+            auto [filename, img] = load_image(entry->string(), flags);
+            detail::invoke_process(fun, filename, img);
+        }
+    }
+
+    template<typename ImageProcessFun>
+    void process_images_recursive(std::string const& root, ImageProcessFun fun)
+    {
+        process_images_recursive(root, fun, cv::IMREAD_COLOR);
+    }
+
+    template<typename ImageProcessFun>
+    void process_images_recursive_parallel(std::string const& root,
+                                           ImageProcessFun fun,
+                                           int flags)
+    {
+        FileStream stream{root};
+        detail::run_image_pipeline(
+            [&stream] {
+                return stream.next();
+            },
+            fun,
+            detail::default_max_tokens(),
+            flags);
+    }
+
+    template<typename ImageProcessFun>
+    void process_images_recursive_parallel(std::string const& root, ImageProcessFun fun)
+    {
+        process_images_recursive_parallel(root, fun, cv::IMREAD_COLOR);
+    }
+
+    template<typename FileProcessFun>
+    void process_files_recursive(std::string const& root, FileProcessFun fun)
+    {
+        FileStream stream{root};
+        while (auto entry = stream.next())
+        {
+            detail::invoke_process(fun, entry->string());
+        }
+    }
+
+    template<typename FileProcessFun>
+    void process_files_recursive_parallel(std::string const& root, FileProcessFun fun)
+    {
+        FileStream stream{root};
+        detail::run_file_pipeline(
+            [&stream] {
+                return stream.next();
+            },
+            fun,
+            detail::default_max_tokens());
+    }
+
+    template<typename BatchProcessFun>
+    void process_images_batched(std::string const& root,
+                                std::size_t batch_size,
+                                BatchProcessFun fun,
+                                int flags,
+                                PartialBatchPolicy policy)
+    {
+        auto files = get_file_paths_from_root(root);
+        for (auto const& batch : detail::make_batches(files, batch_size, policy))
+        {
+            auto [names, images] = detail::load_batch(batch, batch_size, flags, policy);
+            detail::invoke_process(fun, names, images);
+        }
+    }
+
+    template<typename BatchProcessFun>
+    void process_images_batched(std::string const& root,
+                                std::size_t batch_size,
+                                BatchProcessFun fun,
+                                int flags)
+    {
+        process_images_batched(root, batch_size, fun, flags, PartialBatchPolicy::keep);
+    }
+
+    template<typename BatchProcessFun>
+    void process_images_batched(std::string const& root,
+                                std::size_t batch_size,
+                                BatchProcessFun fun)
+    {
+        process_images_batched(root, batch_size, fun, cv::IMREAD_COLOR);
+    }
+
+    template<typename BatchProcessFun>
+    void process_images_batched_parallel(std::string const& root,
+                                         std::size_t batch_size,
+                                         BatchProcessFun fun,
+                                         int flags,
+                                         PartialBatchPolicy policy)
+    {
+        auto files   = get_file_paths_from_root(root);
+        auto batches = detail::make_batches(files, batch_size, policy);
+        oneapi::tbb::parallel_for_each(
+            batches.begin(),
+            batches.end(),
+            [fun, batch_size, flags, policy](
+                std::vector<std::filesystem::path> const& batch) {
+                auto [names, images] =
+                    detail::load_batch(batch, batch_size, flags, policy);
+                detail::invoke_process(fun, names, images);
+            });
+    }
+
+    template<typename BatchProcessFun>
+    void process_images_batched_parallel(std::string const& root,
+                                         std::size_t batch_size,
+                                         BatchProcessFun fun,
+                                         int flags)
+    {
+        process_images_batched_parallel(root,
+                                        batch_size,
+                                        fun,
+                                        flags,
+                                        PartialBatchPolicy::keep);
+    }
+
+    template<typename BatchProcessFun>
+    void process_images_batched_parallel(std::string const& root,
+                                         std::size_t batch_size,
+                                         BatchProcessFun fun)
+    {
+        process_images_batched_parallel(root, batch_size, fun, cv::IMREAD_COLOR);
+    }
 } // namespace rad
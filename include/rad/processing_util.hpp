@@ -1,18 +1,123 @@
 #pragma once
 
+#include <opencv2/core/hal/interface.h>
 #include <opencv2/core/mat.hpp>
 
+#include <cstddef>
+#include <cstdint>
 #include <filesystem>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
 namespace rad
 {
+    class ImageCache;
+
+    enum class ImageReadMode
+    {
+        imread = 0,
+        mapped,
+    };
+
+    struct ImageFilter
+    {
+        std::vector<std::string> extensions{".bmp",
+                                            ".dib",
+                                            ".exr",
+                                            ".gif",
+                                            ".hdr",
+                                            ".jp2",
+                                            ".jpe",
+                                            ".jpeg",
+                                            ".jpg",
+                                            ".pbm",
+                                            ".pfm",
+                                            ".pgm",
+                                            ".pic",
+                                            ".png",
+                                            ".pnm",
+                                            ".ppm",
+                                            ".pxm",
+                                            ".ras",
+                                            ".sr",
+                                            ".tif",
+                                            ".tiff",
+                                            ".webp"};
+        bool check_signature{true};
+    };
+
+    struct ShardSpec
+    {
+        std::size_t index{0};
+        std::size_t count{1};
+    };
+
+    enum class ImageFormat
+    {
+        jpeg = 0,
+        png,
+        bmp,
+    };
+
+    struct ImageHeader
+    {
+        int width{0};
+        int height{0};
+        int channels{0};
+        int depth{CV_8U};
+        ImageFormat format{ImageFormat::jpeg};
+    };
+
+    bool has_image_extension(std::filesystem::path const& path,
+                             std::vector<std::string> const& extensions);
+    bool has_image_signature(std::uint8_t const* data, std::size_t size);
+    bool has_image_signature(std::filesystem::path const& path);
+    bool is_image_file(std::filesystem::path const& path, ImageFilter const& filter);
+
+    std::optional<ImageHeader> read_image_header(std::filesystem::path const& path);
+    std::size_t estimate_decoded_size(std::filesystem::path const& path, int flags);
+
     std::vector<std::filesystem::path> get_file_paths_from_root(std::string const& root);
+    std::vector<std::filesystem::path>
+    get_file_paths_from_root(std::string const& root, ImageFilter const& filter);
+
+    std::vector<std::uint8_t> read_file_bytes(std::string const& path);
+    cv::Mat decode_image(std::vector<std::uint8_t> const& buffer, int flags);
+    cv::Mat decode_image(std::uint8_t const* data, std::size_t size, int flags);
+
+    std::vector<std::uintmax_t>
+    get_file_sizes(std::vector<std::filesystem::path> const& files);
+    std::vector<std::filesystem::path>
+    sort_by_file_size(std::vector<std::filesystem::path> const& files);
+    std::vector<std::vector<std::filesystem::path>>
+    partition_by_file_size(std::vector<std::filesystem::path> const& files,
+                           std::size_t num_chunks);
+
+    std::uint64_t fnv1a_hash(std::string_view str);
+    bool is_in_shard(std::filesystem::path const& path,
+                     std::filesystem::path const& root,
+                     ShardSpec const& shard);
+    std::vector<std::filesystem::path>
+    select_shard(std::vector<std::filesystem::path> const& files,
+                 std::string const& root,
+                 ShardSpec const& shard);
 
     std::pair<std::string, cv::Mat> load_image(std::string const& path, int flags);
     std::pair<std::string, cv::Mat> load_image(std::string const& path);
+    std::pair<std::string, cv::Mat>
+    load_image(std::string const& path, int flags, ImageFilter const& filter);
+    std::pair<std::string, cv::Mat>
+    load_image(std::string const& path, int flags, ImageReadMode mode);
+    std::pair<std::string, cv::Mat>
+    load_image(std::string const& path, int flags, int long_edge);
+
+    // The image shares its pixels with the cache, so it must be cloned before it is
+    // modified.
+    std::pair<std::string, cv::Mat>
+    load_image(std::string const& path, int flags, ImageCache& cache);
 
     void create_result_dir(std::string const& root, std::string const& app_name);
     void save_result(cv::Mat const& img,
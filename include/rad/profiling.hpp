@@ -0,0 +1,93 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace rad::profiling
+{
+    enum class Stage
+    {
+        load = 0,
+        read,
+        decode,
+        process,
+        save,
+    };
+
+    static constexpr std::size_t num_stages{5};
+
+    struct StageSummary
+    {
+        std::size_t count{0};
+        std::chrono::nanoseconds total{0};
+        std::chrono::nanoseconds p50{0};
+        std::chrono::nanoseconds p90{0};
+        std::chrono::nanoseconds p99{0};
+        std::chrono::nanoseconds max{0};
+    };
+
+    struct Summary
+    {
+        std::array<StageSummary, num_stages> stages;
+        std::size_t num_images{0};
+        std::uint64_t bytes_read{0};
+        std::chrono::nanoseconds wall_time{0};
+        double images_per_second{0.0};
+        double bytes_per_second{0.0};
+
+        [[nodiscard]]
+        StageSummary const& operator[](Stage stage) const
+        {
+            return stages[static_cast<std::size_t>(stage)];
+        }
+    };
+
+    constexpr bool is_enabled()
+    {
+#if defined(RAD_PROFILING_ENABLED)
+        return true;
+#else
+        return false;
+#endif
+    }
+
+#if defined(RAD_PROFILING_ENABLED)
+    class StageTimer
+    {
+    public:
+        explicit StageTimer(Stage stage);
+
+        StageTimer(StageTimer const&) = delete;
+        StageTimer(StageTimer&&)      = delete;
+        ~StageTimer();
+
+        StageTimer& operator=(StageTimer const&) = delete;
+        StageTimer& operator=(StageTimer&&)      = delete;
+
+    private:
+        Stage m_stage;
+        std::chrono::steady_clock::time_point m_start;
+    };
+
+    void record_bytes(std::uint64_t bytes);
+#else
+    // With profiling disabled the timer is an empty type, so every use of it compiles
+    // down to nothing.
+    class StageTimer
+    {
+    public:
+        explicit StageTimer(Stage)
+        {}
+    };
+
+    inline void record_bytes(std::uint64_t)
+    {}
+#endif
+
+    void reset();
+    Summary get_summary();
+    std::string format_summary(Summary const& summary);
+} // namespace rad::profiling
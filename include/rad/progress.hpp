@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+namespace rad
+{
+    struct ProgressSnapshot
+    {
+        std::size_t total{0};
+        std::size_t processed{0};
+        std::size_t failed{0};
+        std::size_t remaining{0};
+        std::uint64_t bytes_read{0};
+    };
+
+    class ProgressContext
+    {
+    public:
+        using ProgressCallback = std::function<void(ProgressSnapshot const&)>;
+
+        static constexpr std::chrono::milliseconds default_interval{500};
+
+        ProgressContext();
+        explicit ProgressContext(ProgressCallback callback);
+        ProgressContext(ProgressCallback callback, std::chrono::milliseconds interval);
+
+        ProgressContext(ProgressContext const&) = delete;
+        ProgressContext(ProgressContext&&)      = delete;
+        ~ProgressContext();
+
+        ProgressContext& operator=(ProgressContext const&) = delete;
+        ProgressContext& operator=(ProgressContext&&)      = delete;
+
+        void cancel();
+
+        [[nodiscard]]
+        bool is_cancelled() const;
+
+        void start(std::size_t total);
+        void finish();
+
+        void record_processed(std::uint64_t bytes_read);
+        void record_failed();
+
+        [[nodiscard]]
+        ProgressSnapshot snapshot() const;
+
+    private:
+        // Each worker thread gets its own cache line so the counters never bounce
+        // between cores. Snapshots sum across all of them.
+        struct alignas(64) Counters
+        {
+            std::atomic<std::size_t> processed{0};
+            std::atomic<std::size_t> failed{0};
+            std::atomic<std::uint64_t> bytes_read{0};
+        };
+
+        Counters& local_counters();
+        void maybe_report();
+        void report();
+
+        ProgressCallback m_callback;
+        std::chrono::steady_clock::duration m_interval;
+        std::atomic<std::chrono::steady_clock::rep> m_last_report{0};
+        std::mutex m_callback_mutex;
+
+        std::atomic<bool> m_cancelled{false};
+        std::atomic<std::size_t> m_total{0};
+        std::size_t m_num_counters;
+        std::unique_ptr<Counters[]> m_counters; // NOLINT(modernize-avoid-c-arrays)
+    };
+} // namespace rad
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+namespace rad
+{
+    std::uint64_t
+    xxhash64(std::uint8_t const* data, std::size_t size, std::uint64_t seed);
+    std::uint64_t xxhash64(std::string_view str, std::uint64_t seed);
+
+    // Stores results keyed by the contents of the input file they were computed from
+    // and a version tag, so reruns can skip inputs that haven't changed. The version
+    // should be bumped whenever the processing changes in a way that affects the
+    // results.
+    class ResultCache
+    {
+    public:
+        ResultCache(std::filesystem::path const& root, std::string const& version);
+
+        ResultCache(ResultCache const&) = delete;
+        ResultCache(ResultCache&&)      = delete;
+        ~ResultCache()                  = default;
+
+        ResultCache& operator=(ResultCache const&) = delete;
+        ResultCache& operator=(ResultCache&&)      = delete;
+
+        [[nodiscard]]
+        std::uint64_t get_key(std::filesystem::path const& input) const;
+
+        // The context tells apart results computed from the same input in different
+        // ways, such as with different decode flags or by different apps.
+        [[nodiscard]]
+        std::uint64_t get_key(std::filesystem::path const& input,
+                              std::string_view context) const;
+
+        // Places the cached result for key at destination, hard-linking it where the
+        // filesystem allows it and copying otherwise. Returns false on a miss. Since the
+        // destination may share its contents with the cache, it has to be removed
+        // rather than written over in place, which save_result already does.
+        bool restore(std::uint64_t key, std::filesystem::path const& destination);
+
+        // The result is copied, so it can be freely rewritten afterwards.
+        void store(std::uint64_t key, std::filesystem::path const& result);
+
+        [[nodiscard]]
+        std::filesystem::path const& root() const;
+
+        [[nodiscard]]
+        std::size_t num_hits() const;
+
+        [[nodiscard]]
+        std::size_t num_stores() const;
+
+    private:
+        [[nodiscard]]
+        std::filesystem::path get_entry_path(std::uint64_t key) const;
+
+        std::filesystem::path m_root;
+        std::uint64_t m_seed;
+        std::atomic<std::size_t> m_num_hits{0};
+        std::atomic<std::size_t> m_num_stores{0};
+        std::atomic<std::size_t> m_next_temp{0};
+    };
+} // namespace rad
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "mapped_file.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace rad
+{
+    struct TarMember
+    {
+        std::string name;
+        std::size_t offset{0};
+        std::size_t size{0};
+    };
+
+    // Read-only view of an uncompressed tar archive. The archive is memory-mapped and
+    // its headers are scanned once on construction to build an index of the regular
+    // files it contains, so member contents can be read in place without extracting
+    // them. Supports ustar, GNU long names and pax extended headers.
+    class TarArchive
+    {
+    public:
+        explicit TarArchive(std::filesystem::path const& path);
+
+        TarArchive(TarArchive const&) = delete;
+        TarArchive(TarArchive&&)      = delete;
+        ~TarArchive()                 = default;
+
+        TarArchive& operator=(TarArchive const&) = delete;
+        TarArchive& operator=(TarArchive&&)      = delete;
+
+        [[nodiscard]]
+        std::vector<TarMember> const& members() const;
+
+        // Returns a pointer to the contents of the member. It remains valid for as
+        // long as the archive is alive.
+        [[nodiscard]]
+        std::uint8_t const* data(TarMember const& member) const;
+
+        [[nodiscard]]
+        std::filesystem::path const& path() const;
+
+    private:
+        void build_index();
+
+        std::filesystem::path m_path;
+        MappedFile m_file;
+        std::vector<TarMember> m_members;
+    };
+} // namespace rad
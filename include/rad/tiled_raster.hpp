@@ -0,0 +1,92 @@
+#pragma once
+
+#include "mapped_file.hpp"
+
+#include <opencv2/core/hal/interface.h>
+#include <opencv2/core/mat.hpp>
+#include <opencv2/core/types.hpp>
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <vector>
+
+namespace rad
+{
+    // Describes an uncompressed raster stored row by row with no padding between rows,
+    // starting offset bytes into the file.
+    struct RasterLayout
+    {
+        cv::Size size;
+        int type{CV_8UC1};
+        std::size_t offset{0};
+    };
+
+    struct TileSpec
+    {
+        // The region of the image that is read for the tile, including the overlap with
+        // its neighbours and clipped to the image bounds.
+        cv::Rect roi;
+
+        // The region of the image the tile is responsible for. The cores of all the
+        // tiles cover the image exactly once.
+        cv::Rect core;
+    };
+
+    std::vector<TileSpec>
+    make_tiles(cv::Size image_size, cv::Size tile_size, int overlap);
+
+    class RawRasterReader
+    {
+    public:
+        RawRasterReader(std::filesystem::path const& path, RasterLayout const& layout);
+
+        RawRasterReader(RawRasterReader const&) = delete;
+        RawRasterReader(RawRasterReader&&)      = delete;
+        ~RawRasterReader()                      = default;
+
+        RawRasterReader& operator=(RawRasterReader const&) = delete;
+        RawRasterReader& operator=(RawRasterReader&&)      = delete;
+
+        [[nodiscard]]
+        RasterLayout const& layout() const;
+
+        // Returns a view of the region that points straight into the mapped file, so
+        // only the pages that are touched get loaded. The view is read-only and must
+        // not outlive the reader.
+        [[nodiscard]]
+        cv::Mat read(cv::Rect const& roi) const;
+
+    private:
+        RasterLayout m_layout;
+        MappedFile m_file;
+    };
+
+    class RawRasterWriter
+    {
+    public:
+        RawRasterWriter(std::filesystem::path const& path, RasterLayout const& layout);
+
+        RawRasterWriter(RawRasterWriter const&) = delete;
+        RawRasterWriter(RawRasterWriter&&)      = delete;
+        ~RawRasterWriter()                      = default;
+
+        RawRasterWriter& operator=(RawRasterWriter const&) = delete;
+        RawRasterWriter& operator=(RawRasterWriter&&)      = delete;
+
+        [[nodiscard]]
+        RasterLayout const& layout() const;
+
+        // Both functions are safe to call from multiple threads at once.
+        void write(cv::Rect const& roi, cv::Mat const& img);
+        void write_tile(TileSpec const& tile, cv::Mat const& result);
+
+        void flush();
+
+    private:
+        RasterLayout m_layout;
+        std::fstream m_stream;
+        std::mutex m_mutex;
+    };
+} // namespace rad
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <opencv2/core/mat.hpp>
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+
+namespace rad
+{
+    struct VideoFrame
+    {
+        std::size_t index{0};
+        cv::Mat img;
+    };
+
+    class VideoReader
+    {
+    public:
+        static constexpr std::size_t default_ring_size{16};
+
+        explicit VideoReader(std::string const& path);
+        VideoReader(std::string const& path, std::size_t ring_size);
+
+        VideoReader(VideoReader const&) = delete;
+        VideoReader(VideoReader&&)      = delete;
+        ~VideoReader();
+
+        VideoReader& operator=(VideoReader const&) = delete;
+        VideoReader& operator=(VideoReader&&)      = delete;
+
+        [[nodiscard]]
+        std::optional<VideoFrame> next();
+
+    private:
+        bool push(VideoFrame frame);
+        void finish(std::exception_ptr error);
+
+        std::size_t m_ring_size;
+        std::deque<VideoFrame> m_ring;
+        bool m_done{false};
+        bool m_stop{false};
+        std::exception_ptr m_error;
+        std::mutex m_mutex;
+        std::condition_variable m_ready;
+        std::condition_variable m_space;
+        std::thread m_decoder;
+    };
+} // namespace rad
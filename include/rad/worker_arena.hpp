@@ -0,0 +1,48 @@
+#pragma once
+
+#include <oneapi/tbb/task_arena.h>
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace rad
+{
+    class WorkerArena
+    {
+    public:
+        explicit WorkerArena(int max_concurrency);
+        WorkerArena(int max_concurrency, std::vector<int> cpus);
+
+        WorkerArena(WorkerArena const&) = delete;
+        WorkerArena(WorkerArena&&)      = delete;
+        ~WorkerArena();
+
+        WorkerArena& operator=(WorkerArena const&) = delete;
+        WorkerArena& operator=(WorkerArena&&)      = delete;
+
+        [[nodiscard]]
+        int max_concurrency() const;
+
+        [[nodiscard]]
+        std::vector<int> const& cpus() const;
+
+        [[nodiscard]]
+        static bool is_affinity_supported();
+
+        oneapi::tbb::task_arena& get();
+
+        template<typename Fun>
+        decltype(auto) execute(Fun&& fun)
+        {
+            return m_arena.execute(std::forward<Fun>(fun));
+        }
+
+    private:
+        class AffinityObserver;
+
+        std::vector<int> m_cpus;
+        oneapi::tbb::task_arena m_arena;
+        std::unique_ptr<AffinityObserver> m_observer;
+    };
+} // namespace rad
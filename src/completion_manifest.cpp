@@ -0,0 +1,140 @@
+#include "rad/completion_manifest.hpp"
+#include "rad/processing_util.hpp"
+
+#include <fmt/format.h>
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <ios>
+#include <iterator>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+namespace rad
+{
+    namespace fs = std::filesystem;
+
+    CompletionManifest::CompletionManifest(std::string const& root,
+                                           std::string const& app_name) :
+        CompletionManifest{root, app_name, default_flush_threshold}
+    {}
+
+    CompletionManifest::CompletionManifest(std::string const& root,
+                                           std::string const& app_name,
+                                           std::size_t flush_threshold) :
+        m_path{fs::path{root} / app_name / manifest_name},
+        m_flush_threshold{flush_threshold}
+    {
+        if (m_flush_threshold == 0)
+        {
+            throw std::runtime_error{"error: flush threshold must be greater than 0"};
+        }
+
+        create_result_dir(root, app_name);
+
+        if (std::ifstream in{m_path, std::ios::binary}; in)
+        {
+            const std::string contents{std::istreambuf_iterator<char>{in},
+                                       std::istreambuf_iterator<char>{}};
+
+            // Only accept complete lines. If a previous run died in the middle of a
+            // write, the trailing fragment is dropped and that file is redone.
+            std::size_t start{0};
+            for (auto end = contents.find('\n'); end != std::string::npos;
+                 end      = contents.find('\n', start))
+            {
+                if (end > start)
+                {
+                    m_completed.emplace(contents.substr(start, end - start));
+                }
+                start = end + 1;
+            }
+
+            if (start != contents.size())
+            {
+                // Rewrite the manifest without the broken entry so new entries start
+                // on a fresh line.
+                std::ofstream out{m_path, std::ios::binary | std::ios::trunc};
+                out.write(contents.data(), static_cast<std::streamsize>(start));
+            }
+        }
+
+        m_stream.open(m_path, std::ios::binary | std::ios::app);
+        if (!m_stream)
+        {
+            throw std::runtime_error{
+                fmt::format("error: unable to open manifest {}", m_path.string())};
+        }
+    }
+
+    CompletionManifest::~CompletionManifest()
+    {
+        try
+        {
+            flush();
+        }
+        catch (...) // NOLINT(bugprone-empty-catch)
+        {}
+    }
+
+    bool CompletionManifest::is_complete(std::string const& name) const
+    {
+        return m_completed.contains(name);
+    }
+
+    void CompletionManifest::mark_complete(std::string const& name)
+    {
+        m_pending.push(name);
+        ++m_num_new;
+        if (++m_num_pending < m_flush_threshold)
+        {
+            return;
+        }
+
+        // Only one thread writes at a time. Everyone else keeps working and their
+        // entries are picked up by the next flush.
+        const std::unique_lock lock{m_write_mutex, std::try_to_lock};
+        if (lock.owns_lock())
+        {
+            write_pending();
+        }
+    }
+
+    void CompletionManifest::flush()
+    {
+        const std::scoped_lock lock{m_write_mutex};
+        write_pending();
+    }
+
+    std::size_t CompletionManifest::num_completed() const
+    {
+        return m_completed.size() + m_num_new;
+    }
+
+    fs::path const& CompletionManifest::path() const
+    {
+        return m_path;
+    }
+
+    void CompletionManifest::write_pending()
+    {
+        std::string buffer;
+        std::string name;
+        while (m_pending.try_pop(name))
+        {
+            --m_num_pending;
+            buffer += name;
+            buffer += '\n';
+        }
+
+        if (buffer.empty())
+        {
+            return;
+        }
+
+        m_stream.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        m_stream.flush();
+    }
+} // namespace rad
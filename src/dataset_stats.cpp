@@ -0,0 +1,188 @@
+#include "rad/dataset_stats.hpp"
+
+#include "rad/image_utils.hpp"
+#include "rad/processing_util.hpp"
+
+#include <fmt/format.h>
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_reduce.h>
+#include <opencv2/core.hpp>
+#include <opencv2/core/hal/interface.h>
+#include <opencv2/core/mat.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace rad
+{
+    namespace
+    {
+        constexpr int max_channels{4};
+
+        // Running per-channel mean and sum of squared deviations. The statistics of
+        // each image are computed in bulk and merged in with Chan's formula, which
+        // avoids the cancellation of a naive sum of squares over the whole dataset.
+        struct Accumulator
+        {
+            void add(std::string const& path, cv::Mat const& img)
+            {
+                if (img.empty())
+                {
+                    throw std::runtime_error{
+                        fmt::format("error: unable to read image {}", path)};
+                }
+
+                if (channels == 0)
+                {
+                    channels = img.channels();
+                }
+                else if (channels != img.channels())
+                {
+                    throw std::runtime_error{
+                        fmt::format("error: expected {} channels but image {} has {}",
+                                    channels,
+                                    path,
+                                    img.channels())};
+                }
+
+                const cv::Mat as_float = to_normalised_float(img, CV_64F);
+                cv::Scalar img_mean;
+                cv::Scalar img_std;
+                cv::meanStdDev(as_float, img_mean, img_std);
+
+                Accumulator single;
+                single.channels = channels;
+                single.count    = static_cast<std::uint64_t>(as_float.total());
+                single.images   = 1;
+                const auto n    = static_cast<double>(single.count);
+                for (int c{0}; c < channels; ++c)
+                {
+                    single.mean[c] = img_mean[c];
+                    single.m2[c]   = img_std[c] * img_std[c] * n;
+                }
+
+                merge(single);
+            }
+
+            void merge(Accumulator const& other)
+            {
+                if (other.count == 0)
+                {
+                    return;
+                }
+
+                if (count == 0)
+                {
+                    *this = other;
+                    return;
+                }
+
+                if (channels != other.channels)
+                {
+                    throw std::runtime_error{
+                        fmt::format("error: mismatched number of channels: {} vs {}",
+                                    channels,
+                                    other.channels)};
+                }
+
+                const auto na = static_cast<double>(count);
+                const auto nb = static_cast<double>(other.count);
+                const auto n  = na + nb;
+                for (int c{0}; c < channels; ++c)
+                {
+                    const double delta = other.mean[c] - mean[c];
+                    mean[c] += delta * nb / n;
+                    m2[c] += other.m2[c] + delta * delta * na * nb / n;
+                }
+
+                count += other.count;
+                images += other.images;
+            }
+
+            int channels{0};
+            std::uint64_t count{0};
+            std::uint64_t images{0};
+            std::array<double, max_channels> mean{};
+            std::array<double, max_channels> m2{};
+        };
+    } // namespace
+
+    DatasetStats compute_dataset_stats(std::string const& root,
+                                       DatasetStatsOptions const& options)
+    {
+        if (options.sample_stride == 0)
+        {
+            throw std::runtime_error{"error: sample stride must be greater than 0"};
+        }
+
+        if (options.long_edge < 0)
+        {
+            throw std::runtime_error{"error: long edge cannot be negative"};
+        }
+
+        std::vector<fs::path> files;
+        // Sort the listing so the subsample does not depend on directory order.
+        auto all_files = get_file_paths_from_root(root, ImageFilter{});
+        std::ranges::sort(all_files);
+        for (std::size_t i{0}; i < all_files.size(); i += options.sample_stride)
+        {
+            files.push_back(all_files[i]);
+        }
+
+        const auto acc = oneapi::tbb::parallel_reduce(
+            oneapi::tbb::blocked_range<std::size_t>{0, files.size()},
+            Accumulator{},
+            [&files, &options](oneapi::tbb::blocked_range<std::size_t> const& range,
+                               Accumulator partial) {
+                for (auto i = range.begin(); i != range.end(); ++i)
+                {
+                    const auto path = files[i].string();
+                    auto [_, img] =
+                        options.long_edge > 0
+                            ? load_image(path, options.flags, options.long_edge)
+                            : load_image(path, options.flags);
+                    partial.add(path, img);
+                }
+
+                return partial;
+            },
+            [](Accumulator lhs, Accumulator const& rhs) {
+                lhs.merge(rhs);
+                return lhs;
+            });
+
+        if (acc.count == 0)
+        {
+            throw std::runtime_error{
+                fmt::format("error: no images found in {}", root)};
+        }
+
+        DatasetStats stats;
+        stats.channels   = acc.channels;
+        stats.num_images = acc.images;
+        stats.num_pixels = acc.count;
+
+        const auto n = static_cast<double>(acc.count);
+        for (int c{0}; c < acc.channels; ++c)
+        {
+            stats.mean[c] = acc.mean[c];
+            stats.std[c]  = std::sqrt(acc.m2[c] / n);
+        }
+
+        return stats;
+    }
+
+    DatasetStats compute_dataset_stats(std::string const& root)
+    {
+        return compute_dataset_stats(root, {});
+    }
+} // namespace rad
@@ -0,0 +1,133 @@
+#include "rad/file_stream.hpp"
+
+#include <fmt/format.h>
+
+#include <cstddef>
+#include <exception>
+#include <filesystem>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+namespace rad
+{
+    namespace fs = std::filesystem;
+
+    FileStream::FileStream(std::string const& root) :
+        FileStream{root, default_capacity}
+    {}
+
+    FileStream::FileStream(std::string const& root, std::size_t capacity)
+    {
+        if (capacity == 0)
+        {
+            throw std::runtime_error{"error: queue capacity must be greater than 0"};
+        }
+
+        if (!fs::is_directory(root))
+        {
+            throw std::runtime_error{
+                fmt::format("error: {} is not a valid directory", root)};
+        }
+
+        m_queue.set_capacity(static_cast<std::ptrdiff_t>(capacity));
+        m_scanner = std::thread{[this, root_path = fs::path{root}] {
+            try
+            {
+                m_tasks.run([this, root_path] {
+                    scan(root_path);
+                });
+                m_tasks.wait();
+            }
+            catch (...)
+            {
+                m_error = std::current_exception();
+            }
+
+            // An empty path marks the end of the stream.
+            m_queue.push(fs::path{});
+        }};
+    }
+
+    FileStream::~FileStream()
+    {
+        m_stop = true;
+        if (m_scanner.joinable())
+        {
+            // The scan may be blocked on a full queue, so keep draining it until the end
+            // marker shows up.
+            fs::path path;
+            do
+            {
+                m_queue.pop(path);
+            } while (!path.empty());
+
+            m_scanner.join();
+        }
+    }
+
+    std::optional<fs::path> FileStream::next()
+    {
+        if (m_done)
+        {
+            return {};
+        }
+
+        fs::path path;
+        m_queue.pop(path);
+        if (path.empty())
+        {
+            // Put the marker back so any other consumers also see the end of the
+            // stream.
+            m_done = true;
+            m_queue.push(std::move(path));
+            if (m_error)
+            {
+                std::rethrow_exception(m_error);
+            }
+
+            return {};
+        }
+
+        return path;
+    }
+
+    void FileStream::scan(fs::path const& dir)
+    {
+        std::error_code ec;
+        fs::directory_iterator ite{dir,
+                                   fs::directory_options::skip_permission_denied,
+                                   ec};
+        for (; !ec && ite != fs::directory_iterator{}; ite.increment(ec))
+        {
+            if (m_stop)
+            {
+                return;
+            }
+
+            auto const& entry = *ite;
+            std::error_code status_ec;
+            const bool is_dir = entry.is_directory(status_ec);
+            if (is_dir && !entry.is_symlink(status_ec))
+            {
+                m_tasks.run([this, sub_dir = entry.path()] {
+                    scan(sub_dir);
+                });
+            }
+            else if (!is_dir)
+            {
+                m_queue.push(entry.path());
+            }
+        }
+
+        // Errors other than being denied access would silently drop the rest of the
+        // directory, so they end the stream instead.
+        if (ec)
+        {
+            throw fs::filesystem_error{"unable to list directory", dir, ec};
+        }
+    }
+} // namespace rad
@@ -0,0 +1,216 @@
+#include "rad/image_cache.hpp"
+
+#include "rad/processing_util.hpp"
+
+#include <opencv2/core/mat.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <iterator>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    std::uint64_t combine_hash(std::uint64_t seed, std::uint64_t value)
+    {
+        return seed ^ (value + 0x9E3779B97F4A7C15ULL + (seed << 6) + (seed >> 2));
+    }
+
+    std::size_t get_image_bytes(cv::Mat const& img)
+    {
+        return img.total() * img.elemSize();
+    }
+} // namespace
+
+namespace rad
+{
+    std::size_t ImageCacheKeyHash::operator()(ImageCacheKey const& key) const
+    {
+        auto hash = fnv1a_hash(key.path);
+        hash      = combine_hash(hash, static_cast<std::uint64_t>(key.flags));
+        hash      = combine_hash(
+            hash, static_cast<std::uint64_t>(key.mtime.time_since_epoch().count()));
+        return static_cast<std::size_t>(hash);
+    }
+
+    ImageCache::Entry::Entry(ImageCacheKey k,
+                             cv::Mat i,
+                             std::size_t b,
+                             std::uint64_t stamp) :
+        key{std::move(k)},
+        img{std::move(i)},
+        bytes{b},
+        position{stamp},
+        last_used{stamp}
+    {}
+
+    ImageCache::ImageCache(std::size_t max_bytes) :
+        ImageCache{max_bytes, default_num_shards}
+    {}
+
+    ImageCache::ImageCache(std::size_t max_bytes, std::size_t num_shards) :
+        m_max_bytes{max_bytes},
+        m_shards(num_shards)
+    {
+        if (num_shards == 0)
+        {
+            throw std::runtime_error{"error: image cache needs at least one shard"};
+        }
+    }
+
+    std::optional<ImageCacheKey> ImageCache::get_key(fs::path const& path, int flags)
+    {
+        std::error_code ec;
+        const auto mtime = fs::last_write_time(path, ec);
+        if (ec)
+        {
+            return std::nullopt;
+        }
+
+        return ImageCacheKey{.path = path.string(), .flags = flags, .mtime = mtime};
+    }
+
+    std::optional<cv::Mat> ImageCache::find(ImageCacheKey const& key)
+    {
+        auto& shard = get_shard(key);
+        const std::shared_lock lock{shard.mutex};
+        auto it = shard.index.find(key);
+        if (it == shard.index.end())
+        {
+            m_num_misses.fetch_add(1, std::memory_order_relaxed);
+            return std::nullopt;
+        }
+
+        auto& entry = *it->second;
+        entry.last_used.store(m_clock.fetch_add(1, std::memory_order_relaxed) + 1,
+                              std::memory_order_relaxed);
+        m_num_hits.fetch_add(1, std::memory_order_relaxed);
+        return entry.img;
+    }
+
+    void ImageCache::insert(ImageCacheKey const& key, cv::Mat const& img)
+    {
+        const auto bytes = get_image_bytes(img);
+        if (img.empty() || bytes > m_max_bytes)
+        {
+            return;
+        }
+
+        auto& shard = get_shard(key);
+        {
+            const std::unique_lock lock{shard.mutex};
+
+            // Another thread may have decoded the same image in the meantime.
+            if (shard.index.contains(key))
+            {
+                return;
+            }
+
+            evict(shard, bytes);
+
+            const auto stamp = m_clock.fetch_add(1, std::memory_order_relaxed) + 1;
+            shard.entries.emplace_front(key, img, bytes, stamp);
+            shard.index.emplace(key, shard.entries.begin());
+            shard.bytes += bytes;
+            m_size_bytes += bytes;
+        }
+
+        // The shard couldn't free enough on its own, so take the rest from the others.
+        // Only one shard is locked at a time, so inserts never deadlock, but the cache
+        // can briefly go over budget while this runs.
+        for (auto& other : m_shards)
+        {
+            if (m_size_bytes <= m_max_bytes)
+            {
+                break;
+            }
+
+            if (&other != &shard)
+            {
+                const std::unique_lock lock{other.mutex};
+                evict(other, 0);
+            }
+        }
+    }
+
+    void ImageCache::clear()
+    {
+        for (auto& shard : m_shards)
+        {
+            const std::unique_lock lock{shard.mutex};
+            shard.index.clear();
+            shard.entries.clear();
+            m_size_bytes -= shard.bytes;
+            shard.bytes = 0;
+        }
+    }
+
+    std::size_t ImageCache::max_bytes() const
+    {
+        return m_max_bytes;
+    }
+
+    std::size_t ImageCache::size_bytes() const
+    {
+        return m_size_bytes;
+    }
+
+    std::size_t ImageCache::num_entries() const
+    {
+        std::size_t total{0};
+        for (auto const& shard : m_shards)
+        {
+            const std::shared_lock lock{shard.mutex};
+            total += shard.entries.size();
+        }
+
+        return total;
+    }
+
+    std::size_t ImageCache::num_hits() const
+    {
+        return m_num_hits.load(std::memory_order_relaxed);
+    }
+
+    std::size_t ImageCache::num_misses() const
+    {
+        return m_num_misses.load(std::memory_order_relaxed);
+    }
+
+    ImageCache::Shard& ImageCache::get_shard(ImageCacheKey const& key)
+    {
+        return m_shards[ImageCacheKeyHash{}(key) % m_shards.size()];
+    }
+
+    void ImageCache::evict(Shard& shard, std::size_t bytes)
+    {
+        // Entries that were hit since they were last placed at the front get moved back
+        // there instead of being evicted. Lookups are excluded while this runs, so each
+        // entry is moved at most once and the loop always terminates.
+        while (!shard.entries.empty() && m_size_bytes + bytes > m_max_bytes)
+        {
+            auto last       = std::prev(shard.entries.end());
+            const auto used = last->last_used.load(std::memory_order_relaxed);
+            if (used != last->position)
+            {
+                last->position = used;
+                shard.entries.splice(shard.entries.begin(), shard.entries, last);
+                continue;
+            }
+
+            shard.bytes -= last->bytes;
+            m_size_bytes -= last->bytes;
+            shard.index.erase(last->key);
+            shard.entries.erase(last);
+        }
+    }
+} // namespace rad
@@ -0,0 +1,334 @@
+#include "rad/image_shard.hpp"
+
+#include "rad/processing.hpp"
+
+#include <fmt/format.h>
+#include <opencv2/core/hal/interface.h>
+#include <opencv2/core/mat.hpp>
+#include <opencv2/imgcodecs.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    // Each index entry holds the offset, rows, cols, type, name size and name offset of
+    // a record. The names are stored back to back after the entries.
+    constexpr std::size_t index_entry_size{32};
+
+    void put_u32(std::vector<std::uint8_t>& bytes, std::uint32_t value)
+    {
+        for (int i{0}; i < 4; ++i)
+        {
+            bytes.push_back(static_cast<std::uint8_t>(value >> (i * 8)));
+        }
+    }
+
+    void put_u64(std::vector<std::uint8_t>& bytes, std::uint64_t value)
+    {
+        for (int i{0}; i < 8; ++i)
+        {
+            bytes.push_back(static_cast<std::uint8_t>(value >> (i * 8)));
+        }
+    }
+
+    std::uint32_t get_u32(std::uint8_t const* ptr)
+    {
+        std::uint32_t value{0};
+        for (int i{3}; i >= 0; --i)
+        {
+            value = (value << 8) | ptr[i];
+        }
+
+        return value;
+    }
+
+    std::uint64_t get_u64(std::uint8_t const* ptr)
+    {
+        std::uint64_t value{0};
+        for (int i{7}; i >= 0; --i)
+        {
+            value = (value << 8) | ptr[i];
+        }
+
+        return value;
+    }
+
+    std::uint64_t align(std::uint64_t pos)
+    {
+        constexpr auto alignment = rad::ImageShard::alignment;
+        return (pos + alignment - 1) / alignment * alignment;
+    }
+
+    void write_bytes(std::ofstream& stream, void const* data, std::size_t size)
+    {
+        stream.write(static_cast<char const*>(data), static_cast<std::streamsize>(size));
+    }
+
+    std::vector<std::uint8_t> make_header(std::uint64_t num_records,
+                                          std::uint64_t index_offset)
+    {
+        std::vector<std::uint8_t> header{rad::ImageShard::magic.begin(),
+                                         rad::ImageShard::magic.end()};
+        put_u32(header, rad::ImageShard::version);
+        put_u32(header, 0);
+        put_u64(header, num_records);
+        put_u64(header, index_offset);
+        header.resize(rad::ImageShard::header_size, 0);
+        return header;
+    }
+} // namespace
+
+namespace rad
+{
+    ImageShardWriter::ImageShardWriter(fs::path const& path) :
+        m_path{path},
+        m_stream{path, std::ios::binary | std::ios::trunc}
+    {
+        if (!m_stream)
+        {
+            throw std::runtime_error{
+                fmt::format("error: unable to create shard {}", path.string())};
+        }
+
+        // The header stays blank, and so fails the magic check, until finish writes
+        // it with the final values once the index is known.
+        const std::vector<char> header(ImageShard::header_size, 0);
+        write_bytes(m_stream, header.data(), header.size());
+        m_pos = header.size();
+    }
+
+    ImageShardWriter::~ImageShardWriter()
+    {
+        if (!m_finished)
+        {
+            m_stream.close();
+            std::error_code ec;
+            fs::remove(m_path, ec);
+        }
+    }
+
+    void ImageShardWriter::add(std::string const& name, cv::Mat const& img)
+    {
+        if (m_finished)
+        {
+            throw std::runtime_error{"error: cannot add images to a finished shard"};
+        }
+
+        if (img.empty())
+        {
+            throw std::runtime_error{
+                fmt::format("error: cannot add empty image {} to a shard", name)};
+        }
+
+        const auto offset = align(m_pos);
+        const std::vector<char> padding(offset - m_pos, 0);
+        write_bytes(m_stream, padding.data(), padding.size());
+
+        const auto row_bytes = static_cast<std::size_t>(img.cols) * img.elemSize();
+        if (img.isContinuous())
+        {
+            write_bytes(m_stream, img.data, row_bytes * img.rows);
+        }
+        else
+        {
+            for (int row{0}; row < img.rows; ++row)
+            {
+                write_bytes(m_stream, img.ptr(row), row_bytes);
+            }
+        }
+
+        if (!m_stream)
+        {
+            throw std::runtime_error{fmt::format("error: unable to write image {} to {}",
+                                                 name,
+                                                 m_path.string())};
+        }
+
+        m_records.push_back({.name   = name,
+                             .offset = offset,
+                             .rows   = img.rows,
+                             .cols   = img.cols,
+                             .type   = img.type()});
+        m_pos = offset + (row_bytes * img.rows);
+    }
+
+    void ImageShardWriter::finish()
+    {
+        if (m_finished)
+        {
+            return;
+        }
+
+        m_finished = true;
+
+        std::vector<std::uint8_t> index;
+        std::vector<std::uint8_t> names;
+        for (auto const& record : m_records)
+        {
+            put_u64(index, record.offset);
+            put_u32(index, static_cast<std::uint32_t>(record.rows));
+            put_u32(index, static_cast<std::uint32_t>(record.cols));
+            put_u32(index, static_cast<std::uint32_t>(record.type));
+            put_u32(index, static_cast<std::uint32_t>(record.name.size()));
+            put_u64(index, names.size());
+            names.insert(names.end(), record.name.begin(), record.name.end());
+        }
+
+        write_bytes(m_stream, index.data(), index.size());
+        write_bytes(m_stream, names.data(), names.size());
+
+        const auto header = make_header(m_records.size(), m_pos);
+        m_stream.seekp(0);
+        write_bytes(m_stream, header.data(), header.size());
+        m_stream.close();
+        if (m_stream.fail())
+        {
+            throw std::runtime_error{
+                fmt::format("error: unable to finish shard {}", m_path.string())};
+        }
+    }
+
+    std::size_t ImageShardWriter::size() const
+    {
+        return m_records.size();
+    }
+
+    ImageShard::ImageShard(fs::path const& path) :
+        m_file{path, MapMode::copy_on_write}
+    {
+        auto throw_invalid = [&path](std::string_view reason) {
+            throw std::runtime_error{
+                fmt::format("error: invalid shard {}: {}", path.string(), reason)};
+        };
+
+        std::uint8_t const* base = m_file.data();
+        const std::uint64_t size = m_file.size();
+        if (size < header_size || !std::equal(magic.begin(), magic.end(), base))
+        {
+            throw_invalid("bad header");
+        }
+
+        if (get_u32(base + magic.size()) != version)
+        {
+            throw_invalid("unsupported version");
+        }
+
+        // Every bound is checked by subtracting from a value already known to be in
+        // range, so corrupt offsets and sizes can't wrap around.
+        const auto num_records  = get_u64(base + 16);
+        const auto index_offset = get_u64(base + 24);
+        if (index_offset < header_size || index_offset > size
+            || num_records > (size - index_offset) / index_entry_size)
+        {
+            throw_invalid("index out of bounds");
+        }
+
+        const auto names_offset = index_offset + (num_records * index_entry_size);
+        m_records.reserve(num_records);
+        for (std::uint64_t i{0}; i < num_records; ++i)
+        {
+            std::uint8_t const* entry = base + index_offset + (i * index_entry_size);
+            const auto name_size      = get_u32(entry + 20);
+            const auto name_start     = get_u64(entry + 24);
+            if (name_start > size - names_offset
+                || name_size > size - names_offset - name_start)
+            {
+                throw_invalid("name out of bounds");
+            }
+
+            const auto name_offset = names_offset + name_start;
+            ShardRecord record{
+                .name   = {reinterpret_cast<char const*>(base + name_offset), // NOLINT
+                           name_size},
+                .offset = get_u64(entry),
+                .rows   = static_cast<int>(get_u32(entry + 8)),
+                .cols   = static_cast<int>(get_u32(entry + 12)),
+                .type   = static_cast<int>(get_u32(entry + 16))};
+            if (record.type < 0 || record.type != CV_MAT_TYPE(record.type))
+            {
+                throw_invalid(fmt::format("record {} has an invalid type", record.name));
+            }
+
+            if (record.offset < header_size || record.offset % alignment != 0)
+            {
+                throw_invalid(fmt::format("record {} is misaligned", record.name));
+            }
+
+            if (record.rows <= 0 || record.cols <= 0 || record.offset > index_offset)
+            {
+                throw_invalid(fmt::format("record {} out of bounds", record.name));
+            }
+
+            const auto row_bytes = static_cast<std::uint64_t>(record.cols)
+                                   * CV_ELEM_SIZE(record.type);
+            if (static_cast<std::uint64_t>(record.rows)
+                > (index_offset - record.offset) / row_bytes)
+            {
+                throw_invalid(fmt::format("record {} out of bounds", record.name));
+            }
+
+            m_records.push_back(std::move(record));
+        }
+    }
+
+    std::vector<ShardRecord> const& ImageShard::records() const
+    {
+        return m_records;
+    }
+
+    std::size_t ImageShard::size() const
+    {
+        return m_records.size();
+    }
+
+    cv::Mat ImageShard::image(ShardRecord const& record) const
+    {
+        // The mapping is copy-on-write, so handing out a writable header is safe.
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+        auto* data = const_cast<std::uint8_t*>(m_file.data() + record.offset);
+        return {record.rows, record.cols, record.type, data};
+    }
+
+    cv::Mat ImageShard::image(std::size_t index) const
+    {
+        return image(m_records.at(index));
+    }
+
+    void write_image_shard(std::string const& root, fs::path const& path, int flags)
+    {
+        // Decode in parallel, but write the records in the order the files were listed
+        // in.
+        ImageShardWriter writer{path};
+        process_images_ordered(
+            root,
+            [](std::string const&, cv::Mat const& img) {
+                return img;
+            },
+            [&writer](std::string const& name, cv::Mat const& img) {
+                if (!img.empty())
+                {
+                    writer.add(name, img);
+                }
+            },
+            detail::default_max_tokens(),
+            flags);
+        writer.finish();
+    }
+
+    void write_image_shard(std::string const& root, fs::path const& path)
+    {
+        write_image_shard(root, path, cv::IMREAD_COLOR);
+    }
+} // namespace rad
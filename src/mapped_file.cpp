@@ -0,0 +1,233 @@
+#include "rad/mapped_file.hpp"
+
+#include <fmt/format.h>
+#include <zeus/platform.hpp> // NOLINT(misc-include-cleaner)
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+#if defined(ZEUS_PLATFORM_WINDOWS)
+#    ifndef NOMINMAX
+#        define NOMINMAX
+#    endif
+#    ifndef WIN32_LEAN_AND_MEAN
+#        define WIN32_LEAN_AND_MEAN
+#    endif
+#    include <windows.h>
+#else
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    [[noreturn]] void throw_map_error(fs::path const& path)
+    {
+        throw std::runtime_error{
+            fmt::format("error: unable to map file {}", path.string())};
+    }
+
+#if defined(ZEUS_PLATFORM_WINDOWS)
+    std::pair<std::uint8_t const*, std::size_t>
+    map_file(fs::path const& path, rad::MapMode mode, rad::AccessHint hint)
+    {
+        DWORD access_flags{0};
+        switch (hint)
+        {
+        case rad::AccessHint::sequential:
+            access_flags = FILE_FLAG_SEQUENTIAL_SCAN;
+            break;
+
+        case rad::AccessHint::random:
+            access_flags = FILE_FLAG_RANDOM_ACCESS;
+            break;
+
+        case rad::AccessHint::normal:
+            break;
+        }
+
+        const bool cow = mode == rad::MapMode::copy_on_write;
+        HANDLE file = CreateFileW(path.c_str(),
+                                  GENERIC_READ,
+                                  FILE_SHARE_READ,
+                                  nullptr,
+                                  OPEN_EXISTING,
+                                  access_flags,
+                                  nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            throw_map_error(path);
+        }
+
+        LARGE_INTEGER file_size{};
+        if (GetFileSizeEx(file, &file_size) == 0)
+        {
+            CloseHandle(file);
+            throw_map_error(path);
+        }
+
+        const auto size = static_cast<std::size_t>(file_size.QuadPart);
+        if (size == 0)
+        {
+            CloseHandle(file);
+            return {nullptr, 0};
+        }
+
+        // The view keeps both the mapping and the file alive, so the handles can be
+        // closed as soon as it has been created.
+        HANDLE mapping = CreateFileMappingW(file,
+                                            nullptr,
+                                            cow ? PAGE_WRITECOPY : PAGE_READONLY,
+                                            0,
+                                            0,
+                                            nullptr);
+        CloseHandle(file);
+        if (mapping == nullptr)
+        {
+            throw_map_error(path);
+        }
+
+        void* view = MapViewOfFile(mapping, cow ? FILE_MAP_COPY : FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mapping);
+        if (view == nullptr)
+        {
+            throw_map_error(path);
+        }
+
+        return {static_cast<std::uint8_t const*>(view), size};
+    }
+
+    void unmap_file(std::uint8_t const* data, std::size_t)
+    {
+        UnmapViewOfFile(data);
+    }
+#else
+    std::pair<std::uint8_t const*, std::size_t>
+    map_file(fs::path const& path, rad::MapMode mode, rad::AccessHint hint)
+    {
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC); // NOLINT
+        if (fd < 0)
+        {
+            throw_map_error(path);
+        }
+
+        struct stat info{};
+        if (::fstat(fd, &info) != 0)
+        {
+            ::close(fd);
+            throw_map_error(path);
+        }
+
+        const auto size = static_cast<std::size_t>(info.st_size);
+        if (size == 0)
+        {
+            ::close(fd);
+            return {nullptr, 0};
+        }
+
+        // The mapping holds its own reference to the file, so the descriptor isn't
+        // needed past this point.
+        const int prot =
+            mode == rad::MapMode::copy_on_write ? PROT_READ | PROT_WRITE : PROT_READ;
+        void* ptr = ::mmap(nullptr, size, prot, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (ptr == MAP_FAILED) // NOLINT(cppcoreguidelines-pro-type-cstyle-cast)
+        {
+            throw_map_error(path);
+        }
+
+        switch (hint)
+        {
+        case rad::AccessHint::sequential:
+            ::madvise(ptr, size, MADV_SEQUENTIAL);
+            break;
+
+        case rad::AccessHint::random:
+            ::madvise(ptr, size, MADV_RANDOM);
+            break;
+
+        case rad::AccessHint::normal:
+            break;
+        }
+
+        return {static_cast<std::uint8_t const*>(ptr), size};
+    }
+
+    void unmap_file(std::uint8_t const* data, std::size_t size)
+    {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+        ::munmap(const_cast<std::uint8_t*>(data), size);
+    }
+#endif
+} // namespace
+
+namespace rad
+{
+    MappedFile::MappedFile(fs::path const& path) :
+        MappedFile{path, MapMode::read_only}
+    {}
+
+    MappedFile::MappedFile(fs::path const& path, MapMode mode) :
+        MappedFile{path, mode, AccessHint::sequential}
+    {}
+
+    MappedFile::MappedFile(fs::path const& path, MapMode mode, AccessHint hint)
+    {
+        std::tie(m_data, m_size) = map_file(path, mode, hint);
+    }
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept :
+        m_data{std::exchange(other.m_data, nullptr)},
+        m_size{std::exchange(other.m_size, 0)}
+    {}
+
+    MappedFile::~MappedFile()
+    {
+        unmap();
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+    {
+        if (this != &other)
+        {
+            unmap();
+            m_data = std::exchange(other.m_data, nullptr);
+            m_size = std::exchange(other.m_size, 0);
+        }
+
+        return *this;
+    }
+
+    std::uint8_t const* MappedFile::data() const
+    {
+        return m_data;
+    }
+
+    std::size_t MappedFile::size() const
+    {
+        return m_size;
+    }
+
+    bool MappedFile::empty() const
+    {
+        return m_size == 0;
+    }
+
+    void MappedFile::unmap()
+    {
+        if (m_data != nullptr)
+        {
+            unmap_file(m_data, m_size);
+            m_data = nullptr;
+            m_size = 0;
+        }
+    }
+} // namespace rad
@@ -0,0 +1,104 @@
+#include "rad/memory_budget.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+
+namespace rad
+{
+    MemoryBudget::Reservation::Reservation(MemoryBudget* budget, std::size_t bytes) :
+        m_budget{budget},
+        m_bytes{bytes}
+    {}
+
+    MemoryBudget::Reservation::Reservation(Reservation&& other) noexcept :
+        m_budget{std::exchange(other.m_budget, nullptr)},
+        m_bytes{std::exchange(other.m_bytes, 0)}
+    {}
+
+    MemoryBudget::Reservation::~Reservation()
+    {
+        release();
+    }
+
+    MemoryBudget::Reservation&
+    MemoryBudget::Reservation::operator=(Reservation&& other) noexcept
+    {
+        if (this != &other)
+        {
+            release();
+            m_budget = std::exchange(other.m_budget, nullptr);
+            m_bytes  = std::exchange(other.m_bytes, 0);
+        }
+
+        return *this;
+    }
+
+    std::size_t MemoryBudget::Reservation::size() const
+    {
+        return m_bytes;
+    }
+
+    void MemoryBudget::Reservation::release()
+    {
+        if (m_budget != nullptr)
+        {
+            m_budget->release(m_bytes);
+            m_budget = nullptr;
+            m_bytes  = 0;
+        }
+    }
+
+    MemoryBudget::MemoryBudget(std::size_t max_bytes) :
+        m_max_bytes{max_bytes}
+    {
+        if (m_max_bytes == 0)
+        {
+            throw std::runtime_error{"error: memory budget must be greater than 0"};
+        }
+    }
+
+    MemoryBudget::Reservation MemoryBudget::reserve(std::size_t bytes)
+    {
+        std::unique_lock lock{m_mutex};
+
+        // A request larger than the whole budget is let through once nothing else is
+        // in flight, otherwise it would never be admitted.
+        m_released.wait(lock, [this, bytes] {
+            return m_in_flight == 0 || m_in_flight + bytes <= m_max_bytes;
+        });
+
+        m_in_flight += bytes;
+        m_peak = std::max(m_peak, m_in_flight);
+        return {this, bytes};
+    }
+
+    std::size_t MemoryBudget::max_bytes() const
+    {
+        return m_max_bytes;
+    }
+
+    std::size_t MemoryBudget::bytes_in_flight() const
+    {
+        const std::scoped_lock lock{m_mutex};
+        return m_in_flight;
+    }
+
+    std::size_t MemoryBudget::peak_bytes_in_flight() const
+    {
+        const std::scoped_lock lock{m_mutex};
+        return m_peak;
+    }
+
+    void MemoryBudget::release(std::size_t bytes)
+    {
+        {
+            const std::scoped_lock lock{m_mutex};
+            m_in_flight -= bytes;
+        }
+
+        m_released.notify_all();
+    }
+} // namespace rad
@@ -0,0 +1,897 @@
+#include "rad/prefetch_reader.hpp"
+#include "rad/processing_util.hpp"
+
+#include <fmt/format.h>
+#include <zeus/platform.hpp> // NOLINT(misc-include-cleaner)
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if !defined(ZEUS_PLATFORM_WINDOWS)
+#    include <cerrno>
+#    include <fcntl.h>
+#    include <sys/stat.h>
+#    include <sys/types.h>
+#    include <system_error>
+#    include <unistd.h>
+#endif
+
+// NOLINTBEGIN(cppcoreguidelines-macro-usage)
+#if defined(ZEUS_PLATFORM_LINUX) && __has_include(<linux/io_uring.h>)
+#    define RAD_HAS_IO_URING
+#    include <atomic>
+#    include <linux/io_uring.h>
+#    include <sys/mman.h>
+#    include <sys/syscall.h>
+#    include <sys/uio.h>
+#endif
+// NOLINTEND(cppcoreguidelines-macro-usage)
+
+namespace
+{
+    namespace fs = std::filesystem;
+
+    struct Slot
+    {
+        std::vector<std::uint8_t> bytes;
+        bool ready{false};
+    };
+
+#if !defined(ZEUS_PLATFORM_WINDOWS)
+    class FileDescriptor
+    {
+    public:
+        // Takes ownership of an already open descriptor.
+        explicit FileDescriptor(int fd) :
+            m_fd{fd}
+        {}
+
+        explicit FileDescriptor(fs::path const& path) :
+            m_fd{::open(path.c_str(), O_RDONLY | O_CLOEXEC)} // NOLINT
+        {
+            if (m_fd < 0)
+            {
+                throw std::runtime_error{
+                    fmt::format("error: unable to open file {}", path.string())};
+            }
+        }
+
+        FileDescriptor(FileDescriptor const&) = delete;
+
+        FileDescriptor(FileDescriptor&& other) noexcept :
+            m_fd{std::exchange(other.m_fd, -1)}
+        {}
+
+        ~FileDescriptor()
+        {
+            if (m_fd >= 0)
+            {
+                ::close(m_fd);
+            }
+        }
+
+        FileDescriptor& operator=(FileDescriptor const&) = delete;
+
+        FileDescriptor& operator=(FileDescriptor&& other) noexcept
+        {
+            std::swap(m_fd, other.m_fd);
+            return *this;
+        }
+
+        [[nodiscard]]
+        int get() const
+        {
+            return m_fd;
+        }
+
+        [[nodiscard]]
+        std::size_t size() const
+        {
+            struct stat info{};
+            if (::fstat(m_fd, &info) != 0)
+            {
+                throw std::system_error{errno, std::generic_category(), "fstat"};
+            }
+
+            return static_cast<std::size_t>(info.st_size);
+        }
+
+    private:
+        int m_fd;
+    };
+
+    std::vector<std::uint8_t> pread_file(fs::path const& path)
+    {
+        const FileDescriptor fd{path};
+        std::vector<std::uint8_t> bytes(fd.size());
+
+        std::size_t offset{0};
+        while (offset < bytes.size())
+        {
+            const auto ret = ::pread(fd.get(),
+                                     bytes.data() + offset,
+                                     bytes.size() - offset,
+                                     static_cast<off_t>(offset));
+            if (ret < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+
+                throw std::runtime_error{
+                    fmt::format("error: unable to read file {}", path.string())};
+            }
+
+            if (ret == 0)
+            {
+                // The file shrank after we checked its size.
+                bytes.resize(offset);
+                break;
+            }
+
+            offset += static_cast<std::size_t>(ret);
+        }
+
+        return bytes;
+    }
+#endif
+
+    std::vector<std::uint8_t> read_whole_file(fs::path const& path)
+    {
+#if defined(ZEUS_PLATFORM_WINDOWS)
+        return rad::read_file_bytes(path.string());
+#else
+        return pread_file(path);
+#endif
+    }
+
+#if defined(RAD_HAS_IO_URING)
+    // A minimal io_uring wrapper over the raw system calls so we don't need to depend
+    // on liburing. It only supports what the reader needs: queueing opens, stats and
+    // vectored reads, submitting them in batches and reaping their completions, all
+    // from a single thread.
+    class IoUring
+    {
+    public:
+        explicit IoUring(unsigned entries)
+        {
+            io_uring_params params{};
+            m_fd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+            if (m_fd < 0)
+            {
+                throw std::system_error{errno, std::generic_category(), "io_uring_setup"};
+            }
+
+            // The destructor doesn't run if we throw from here, so anything mapped so
+            // far has to be released by hand.
+            try
+            {
+                init(params);
+            }
+            catch (...)
+            {
+                release();
+                throw;
+            }
+        }
+
+        IoUring(IoUring const&) = delete;
+        IoUring(IoUring&&)      = delete;
+
+        ~IoUring()
+        {
+            release();
+        }
+
+        IoUring& operator=(IoUring const&) = delete;
+        IoUring& operator=(IoUring&&)      = delete;
+
+        [[nodiscard]]
+        std::size_t capacity() const
+        {
+            return m_capacity;
+        }
+
+        // Queued requests are only handed to the kernel by submit or
+        // wait_completions.
+        void queue_openat(char const* path, std::uint64_t user_data)
+        {
+            queue(user_data, [path](io_uring_sqe& sqe) {
+                sqe.opcode     = IORING_OP_OPENAT;
+                sqe.fd         = AT_FDCWD;
+                sqe.addr       = reinterpret_cast<std::uint64_t>(path);
+                sqe.open_flags = O_RDONLY | O_CLOEXEC; // NOLINT
+            });
+        }
+
+        void queue_statx(int fd, struct statx* info, std::uint64_t user_data)
+        {
+            queue(user_data, [fd, info](io_uring_sqe& sqe) {
+                sqe.opcode      = IORING_OP_STATX;
+                sqe.fd          = fd;
+                sqe.addr        = reinterpret_cast<std::uint64_t>("");
+                sqe.len         = STATX_SIZE;
+                sqe.off         = reinterpret_cast<std::uint64_t>(info);
+                sqe.statx_flags = AT_EMPTY_PATH;
+            });
+        }
+
+        void queue_readv(int fd,
+                         iovec* iov,
+                         std::uint64_t offset,
+                         std::uint64_t user_data)
+        {
+            queue(user_data, [fd, iov, offset](io_uring_sqe& sqe) {
+                sqe.opcode = IORING_OP_READV;
+                sqe.fd     = fd;
+                sqe.addr   = reinterpret_cast<std::uint64_t>(iov);
+                sqe.len    = 1;
+                sqe.off    = offset;
+            });
+        }
+
+        // Hands every queued request to the kernel with a single system call.
+        void submit()
+        {
+            if (m_pending != 0)
+            {
+                m_pending -= enter(m_pending, 0, 0);
+            }
+        }
+
+        // Submits any queued requests and blocks until at least one completion is
+        // available, then hands every available completion to the given function.
+        template<typename CompletionFun>
+        void wait_completions(CompletionFun fun)
+        {
+            for (;;)
+            {
+                unsigned head       = *m_cq_head;
+                const unsigned tail =
+                    std::atomic_ref{*m_cq_tail}.load(std::memory_order_acquire);
+                if (head != tail)
+                {
+                    for (; head != tail; ++head)
+                    {
+                        // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+                        const io_uring_cqe cqe = m_cqes[head & m_cq_mask];
+                        std::atomic_ref{*m_cq_head}.store(head + 1,
+                                                          std::memory_order_release);
+                        fun(cqe);
+                    }
+
+                    return;
+                }
+
+                m_pending -= enter(m_pending, 1, IORING_ENTER_GETEVENTS);
+            }
+        }
+
+    private:
+        void init(io_uring_params const& params)
+        {
+            // Kernels older than 5.6 can't open or stat files through the ring, in
+            // which case the reader falls back to the thread pool.
+            if (!is_supported(IORING_OP_OPENAT) || !is_supported(IORING_OP_STATX))
+            {
+                throw std::system_error{ENOSYS,
+                                        std::generic_category(),
+                                        "io_uring_register"};
+            }
+
+            m_capacity = params.sq_entries;
+            m_sq_size  = params.sq_off.array + (params.sq_entries * sizeof(unsigned));
+            m_cq_size  = params.cq_off.cqes + (params.cq_entries * sizeof(io_uring_cqe));
+            const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+            if (single_mmap)
+            {
+                m_sq_size = std::max(m_sq_size, m_cq_size);
+            }
+
+            m_sq_ptr = map(m_sq_size, IORING_OFF_SQ_RING);
+            m_cq_ptr = single_mmap ? m_sq_ptr : map(m_cq_size, IORING_OFF_CQ_RING);
+            m_sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+            m_sqes = static_cast<io_uring_sqe*>(map(m_sqes_size, IORING_OFF_SQES));
+
+            // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            auto* sq    = static_cast<char*>(m_sq_ptr);
+            auto* cq    = static_cast<char*>(m_cq_ptr);
+            m_sq_tail   = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+            m_sq_mask   = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+            m_sq_array  = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+            m_cq_head   = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+            m_cq_tail   = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+            m_cq_mask   = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+            m_cqes      = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+            // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        }
+
+        void release()
+        {
+            if (m_sqes != nullptr)
+            {
+                ::munmap(m_sqes, m_sqes_size);
+            }
+
+            if (m_cq_ptr != nullptr && m_cq_ptr != m_sq_ptr)
+            {
+                ::munmap(m_cq_ptr, m_cq_size);
+            }
+
+            if (m_sq_ptr != nullptr)
+            {
+                ::munmap(m_sq_ptr, m_sq_size);
+            }
+
+            if (m_fd >= 0)
+            {
+                ::close(m_fd);
+            }
+        }
+
+        template<typename PrepareFun>
+        void queue(std::uint64_t user_data, PrepareFun prepare)
+        {
+            // We are the only producer, so the tail can be read without ordering.
+            const unsigned tail  = *m_sq_tail;
+            const unsigned index = tail & m_sq_mask;
+
+            // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            io_uring_sqe& sqe = m_sqes[index];
+            sqe               = io_uring_sqe{};
+            prepare(sqe);
+            sqe.user_data     = user_data;
+            m_sq_array[index] = index;
+            // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+            std::atomic_ref{*m_sq_tail}.store(tail + 1, std::memory_order_release);
+            ++m_pending;
+        }
+
+        [[nodiscard]]
+        bool is_supported(int opcode) const
+        {
+            constexpr unsigned max_ops{256};
+            std::vector<std::uint8_t> buffer(sizeof(io_uring_probe)
+                                             + (max_ops * sizeof(io_uring_probe_op)));
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+            auto* probe = reinterpret_cast<io_uring_probe*>(buffer.data());
+            if (::syscall(__NR_io_uring_register,
+                          m_fd,
+                          IORING_REGISTER_PROBE,
+                          probe,
+                          max_ops)
+                < 0)
+            {
+                return false;
+            }
+
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            return opcode <= probe->last_op
+                   && (probe->ops[opcode].flags & IO_URING_OP_SUPPORTED) != 0;
+        }
+
+        void* map(std::size_t size, off_t offset) const
+        {
+            void* ptr = ::mmap(nullptr,
+                               size,
+                               PROT_READ | PROT_WRITE,
+                               MAP_SHARED | MAP_POPULATE,
+                               m_fd,
+                               offset);
+            if (ptr == MAP_FAILED) // NOLINT(cppcoreguidelines-pro-type-cstyle-cast)
+            {
+                throw std::system_error{errno, std::generic_category(), "mmap"};
+            }
+
+            return ptr;
+        }
+
+        // Returns the number of requests the kernel consumed.
+        unsigned enter(unsigned to_submit, unsigned min_complete, unsigned flags) const
+        {
+            for (;;)
+            {
+                const auto ret = ::syscall(__NR_io_uring_enter,
+                                           m_fd,
+                                           to_submit,
+                                           min_complete,
+                                           flags,
+                                           nullptr,
+                                           0);
+                if (ret >= 0)
+                {
+                    return static_cast<unsigned>(ret);
+                }
+
+                if (errno != EINTR)
+                {
+                    throw std::system_error{errno,
+                                            std::generic_category(),
+                                            "io_uring_enter"};
+                }
+            }
+        }
+
+        int m_fd{-1};
+        std::size_t m_capacity{0};
+        void* m_sq_ptr{nullptr};
+        std::size_t m_sq_size{0};
+        void* m_cq_ptr{nullptr};
+        std::size_t m_cq_size{0};
+        io_uring_sqe* m_sqes{nullptr};
+        std::size_t m_sqes_size{0};
+        unsigned m_pending{0};
+        unsigned* m_sq_tail{nullptr};
+        unsigned m_sq_mask{0};
+        unsigned* m_sq_array{nullptr};
+        unsigned* m_cq_head{nullptr};
+        unsigned* m_cq_tail{nullptr};
+        unsigned m_cq_mask{0};
+        io_uring_cqe* m_cqes{nullptr};
+    };
+
+    // The kernel caps the number of ring entries, so keep well under that.
+    constexpr unsigned max_ring_entries{1024};
+#endif
+} // namespace
+
+namespace rad
+{
+    class PrefetchReader::Impl
+    {
+    public:
+        Impl(std::vector<fs::path> files, std::size_t window, ReaderBackend backend) :
+            m_files{std::move(files)},
+            m_window{window},
+            m_slots(window)
+        {
+            if (m_window == 0)
+            {
+                throw std::runtime_error{
+                    "error: read-ahead window must be greater than 0"};
+            }
+
+            if (backend != ReaderBackend::thread_pool)
+            {
+#if defined(RAD_HAS_IO_URING)
+                try
+                {
+                    auto ring = std::make_unique<IoUring>(
+                        static_cast<unsigned>(std::min<std::size_t>(m_window,
+                                                                    max_ring_entries)));
+                    m_backend = ReaderBackend::io_uring;
+                    m_threads.emplace_back([this, r = std::move(ring)] {
+                        run_io_uring(*r);
+                    });
+                    return;
+                }
+                catch (std::system_error const&)
+                {
+                    if (backend == ReaderBackend::io_uring)
+                    {
+                        throw;
+                    }
+                }
+#else
+                if (backend == ReaderBackend::io_uring)
+                {
+                    throw std::runtime_error{
+                        "error: io_uring is not available on this platform"};
+                }
+#endif
+            }
+
+            m_backend = ReaderBackend::thread_pool;
+            const auto num_threads = std::min(num_pool_threads, m_window);
+            for (std::size_t i{0}; i < num_threads; ++i)
+            {
+                m_threads.emplace_back([this] {
+                    run_thread_pool_worker();
+                });
+            }
+        }
+
+        Impl(Impl const&) = delete;
+        Impl(Impl&&)      = delete;
+
+        ~Impl()
+        {
+            {
+                const std::scoped_lock lock{m_mutex};
+                m_stop = true;
+            }
+
+            m_space.notify_all();
+            m_ready.notify_all();
+            for (auto& thread : m_threads)
+            {
+                thread.join();
+            }
+        }
+
+        Impl& operator=(Impl const&) = delete;
+        Impl& operator=(Impl&&)      = delete;
+
+        std::optional<FileBuffer> next()
+        {
+            std::unique_lock lock{m_mutex};
+            if (m_consumed == m_files.size())
+            {
+                return {};
+            }
+
+            auto& slot = m_slots[m_consumed % m_window];
+            m_ready.wait(lock, [this, &slot] {
+                return slot.ready || m_failure;
+            });
+
+            if (!slot.ready)
+            {
+                std::rethrow_exception(m_failure);
+            }
+
+            FileBuffer buffer{.path  = m_files[m_consumed],
+                              .bytes = std::move(slot.bytes)};
+            slot.ready = false;
+            ++m_consumed;
+
+            lock.unlock();
+            m_space.notify_all();
+            return buffer;
+        }
+
+        [[nodiscard]]
+        ReaderBackend backend() const
+        {
+            return m_backend;
+        }
+
+    private:
+        void publish(std::size_t index, std::vector<std::uint8_t> bytes)
+        {
+            {
+                const std::scoped_lock lock{m_mutex};
+                auto& slot = m_slots[index % m_window];
+                slot.bytes = std::move(bytes);
+                slot.ready = true;
+            }
+
+            m_ready.notify_all();
+        }
+
+        void fail(std::exception_ptr error)
+        {
+            {
+                const std::scoped_lock lock{m_mutex};
+                m_failure = std::move(error);
+            }
+
+            m_ready.notify_all();
+        }
+
+        void run_thread_pool_worker()
+        {
+            for (;;)
+            {
+                std::size_t index{0};
+                {
+                    std::unique_lock lock{m_mutex};
+                    m_space.wait(lock, [this] {
+                        return m_stop || m_next_read == m_files.size()
+                               || m_next_read < m_consumed + m_window;
+                    });
+
+                    if (m_stop || m_next_read == m_files.size())
+                    {
+                        return;
+                    }
+
+                    index = m_next_read++;
+                }
+
+                try
+                {
+                    publish(index, read_whole_file(m_files[index]));
+                }
+                catch (std::runtime_error const&)
+                {
+                    publish(index, {});
+                }
+                catch (...)
+                {
+                    fail(std::current_exception());
+                    return;
+                }
+            }
+        }
+
+#if defined(RAD_HAS_IO_URING)
+        // Each file is opened, sized and read through the ring, one stage after the
+        // other, so the driver thread never blocks on anything but the ring itself.
+        enum class ReadStage
+        {
+            open = 0,
+            stat,
+            read,
+        };
+
+        struct ReadRequest
+        {
+            ReadStage stage{ReadStage::open};
+            std::optional<FileDescriptor> fd;
+            struct statx info{};
+            std::vector<std::uint8_t> bytes;
+            std::size_t offset{0};
+            iovec iov{};
+            bool queued{false};
+        };
+
+        void run_io_uring(IoUring& ring)
+        {
+            try
+            {
+                drive_io_uring(ring);
+            }
+            catch (...)
+            {
+                fail(std::current_exception());
+            }
+        }
+
+        void drive_io_uring(IoUring& ring)
+        {
+            std::vector<ReadRequest> requests(m_window);
+            try
+            {
+                drive_io_uring(ring, requests);
+            }
+            catch (...)
+            {
+                // The kernel may still be writing into the requests, so they have to
+                // outlive every operation in flight. If the ring can't even be drained,
+                // leaking them is the only safe option left.
+                try
+                {
+                    drain_io_uring(ring, requests);
+                }
+                catch (...)
+                {
+                    static_cast<void>(
+                        std::make_unique<std::vector<ReadRequest>>(std::move(requests))
+                            .release());
+                }
+
+                throw;
+            }
+        }
+
+        static void drain_io_uring(IoUring& ring, std::vector<ReadRequest>& requests)
+        {
+            auto is_queued = [](ReadRequest const& req) {
+                return req.queued;
+            };
+
+            while (std::ranges::any_of(requests, is_queued))
+            {
+                ring.wait_completions([&requests](io_uring_cqe const& cqe) {
+                    requests[cqe.user_data % requests.size()].queued = false;
+                });
+            }
+        }
+
+        void drive_io_uring(IoUring& ring, std::vector<ReadRequest>& requests)
+        {
+            std::size_t in_flight{0};
+            bool stopping{false};
+
+            auto queue = [&](std::size_t index) {
+                auto& req  = requests[index % m_window];
+                req.queued = true;
+                switch (req.stage)
+                {
+                case ReadStage::open:
+                    ring.queue_openat(m_files[index].c_str(), index);
+                    break;
+
+                case ReadStage::stat:
+                    ring.queue_statx(req.fd->get(), &req.info, index);
+                    break;
+
+                case ReadStage::read:
+                    req.iov = iovec{.iov_base = req.bytes.data() + req.offset,
+                                    .iov_len  = req.bytes.size() - req.offset};
+                    ring.queue_readv(req.fd->get(), &req.iov, req.offset, index);
+                    break;
+                }
+            };
+
+            auto finish = [&](std::size_t index, bool failed) {
+                auto& req = requests[index % m_window];
+                req.fd.reset();
+                if (failed)
+                {
+                    req.bytes.clear();
+                }
+
+                if (!stopping)
+                {
+                    publish(index, std::move(req.bytes));
+                }
+
+                req = ReadRequest{};
+                --in_flight;
+            };
+
+            auto start = [&](std::size_t index) {
+                requests[index % m_window] = ReadRequest{};
+                ++in_flight;
+                queue(index);
+            };
+
+            auto on_completion = [&](io_uring_cqe const& cqe) {
+                const auto index = static_cast<std::size_t>(cqe.user_data);
+                auto& req        = requests[index % m_window];
+                req.queued       = false;
+                if (cqe.res == -EINTR || cqe.res == -EAGAIN)
+                {
+                    queue(index);
+                    return;
+                }
+
+                if (cqe.res < 0)
+                {
+                    finish(index, true);
+                    return;
+                }
+
+                switch (req.stage)
+                {
+                case ReadStage::open:
+                    req.fd.emplace(cqe.res);
+                    req.stage = ReadStage::stat;
+                    break;
+
+                case ReadStage::stat:
+                    req.bytes.resize(static_cast<std::size_t>(req.info.stx_size));
+                    req.stage = ReadStage::read;
+                    break;
+
+                case ReadStage::read:
+                    if (cqe.res == 0)
+                    {
+                        // The file shrank after we checked its size.
+                        req.bytes.resize(req.offset);
+                    }
+
+                    req.offset += static_cast<std::size_t>(cqe.res);
+                    break;
+                }
+
+                if (stopping
+                    || (req.stage == ReadStage::read && req.offset >= req.bytes.size()))
+                {
+                    finish(index, false);
+                    return;
+                }
+
+                queue(index);
+            };
+
+            for (;;)
+            {
+                std::size_t first{0};
+                std::size_t last{0};
+                {
+                    std::unique_lock lock{m_mutex};
+                    if (in_flight == 0)
+                    {
+                        m_space.wait(lock, [this] {
+                            return m_stop || m_next_read == m_files.size()
+                                   || m_next_read < m_consumed + m_window;
+                        });
+                    }
+
+                    stopping = m_stop;
+                    if (!stopping)
+                    {
+                        first = m_next_read;
+                        last  = std::min({m_files.size(),
+                                          m_consumed + m_window,
+                                          first + ring.capacity() - in_flight});
+                        m_next_read = std::max(first, last);
+                    }
+                }
+
+                for (auto i = first; i < last; ++i)
+                {
+                    start(i);
+                }
+
+                // Everything started for this window, along with any requests queued
+                // while reaping completions, goes to the kernel in one system call.
+                ring.submit();
+
+                if (in_flight == 0)
+                {
+                    if (stopping || m_next_read == m_files.size())
+                    {
+                        return;
+                    }
+
+                    continue;
+                }
+
+                ring.wait_completions(on_completion);
+            }
+        }
+#endif
+
+        std::vector<fs::path> m_files;
+        std::size_t m_window;
+        ReaderBackend m_backend{ReaderBackend::thread_pool};
+
+        std::vector<Slot> m_slots;
+        std::size_t m_consumed{0};
+        std::size_t m_next_read{0};
+        bool m_stop{false};
+        std::exception_ptr m_failure;
+
+        std::mutex m_mutex;
+        std::condition_variable m_ready;
+        std::condition_variable m_space;
+        std::vector<std::thread> m_threads;
+    };
+
+    PrefetchReader::PrefetchReader(std::vector<fs::path> files, std::size_t window) :
+        PrefetchReader{std::move(files), window, ReaderBackend::automatic}
+    {}
+
+    PrefetchReader::PrefetchReader(std::vector<fs::path> files,
+                                   std::size_t window,
+                                   ReaderBackend backend) :
+        m_impl{std::make_unique<Impl>(std::move(files), window, backend)}
+    {}
+
+    PrefetchReader::~PrefetchReader() = default;
+
+    std::optional<FileBuffer> PrefetchReader::next()
+    {
+        return m_impl->next();
+    }
+
+    ReaderBackend PrefetchReader::backend() const
+    {
+        return m_impl->backend();
+    }
+
+    bool PrefetchReader::is_io_uring_available()
+    {
+#if defined(RAD_HAS_IO_URING)
+        try
+        {
+            const IoUring ring{1};
+            return true;
+        }
+        catch (std::system_error const&)
+        {
+            return false;
+        }
+#else
+        return false;
+#endif
+    }
+} // namespace rad
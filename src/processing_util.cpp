@@ -1,18 +1,430 @@
 #include "rad/processing_util.hpp"
+#include "rad/image_cache.hpp"
+#include "rad/image_utils.hpp"
+#include "rad/mapped_file.hpp"
+#include "rad/profiling.hpp"
 
+#include <fmt/format.h>
+#include <oneapi/tbb/parallel_for.h>
 #include <opencv2/core/hal/interface.h>
 #include <opencv2/core/mat.hpp>
 #include <opencv2/imgcodecs.hpp>
 
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstdlib>
+#include <cstddef>
+#include <cstdint>
 #include <filesystem>
+#include <fstream>
+#include <functional>
+#include <ios>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <queue>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <system_error>
 #include <utility>
 #include <vector>
 
+namespace
+{
+    // Enough bytes to cover the longest signature below.
+    constexpr std::size_t signature_size{16};
+
+    struct ImageSignature
+    {
+        std::size_t offset;
+        std::string_view magic;
+    };
+
+    using namespace std::string_view_literals;
+
+    // clang-format off
+    constexpr std::array image_signatures{
+        ImageSignature{0, "\xFF\xD8\xFF"sv},        // JPEG
+        ImageSignature{0, "\x89PNG\r\n\x1A\n"sv},   // PNG
+        ImageSignature{0, "BM"sv},                  // BMP
+        ImageSignature{0, "II*\0"sv},               // TIFF (little endian)
+        ImageSignature{0, "MM\0*"sv},               // TIFF (big endian)
+        ImageSignature{8, "WEBP"sv},                // WebP
+        ImageSignature{0, "\0\0\0\x0CjP  "sv},      // JPEG 2000
+        ImageSignature{0, "\xFF\x4F\xFF\x51"sv},    // JPEG 2000 codestream
+        ImageSignature{0, "GIF8"sv},                // GIF
+        ImageSignature{0, "\x76\x2F\x31\x01"sv},    // OpenEXR
+        ImageSignature{0, "#?"sv},                  // Radiance HDR
+        ImageSignature{0, "\x59\xA6\x6A\x95"sv},    // Sun raster
+        ImageSignature{0, "PF"sv},                  // PFM (colour)
+        ImageSignature{0, "Pf"sv},                  // PFM (grey)
+    };
+    // clang-format on
+
+    bool has_pnm_signature(std::uint8_t const* data, std::size_t size)
+    {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        return size >= 2 && data[0] == 'P' && data[1] >= '1' && data[1] <= '7';
+    }
+
+    // Used when the decoded size can't be read from the header of the file. Assume a
+    // typical compression ratio for lossy formats.
+    constexpr std::uintmax_t unknown_format_expansion{10};
+
+    constexpr std::uint32_t read_be16(std::uint8_t const* data)
+    {
+        // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        return static_cast<std::uint32_t>(data[0] << 8U) | data[1];
+        // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    }
+
+    constexpr std::uint32_t read_be32(std::uint8_t const* data)
+    {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        return (read_be16(data) << 16U) | read_be16(data + 2);
+    }
+
+    constexpr std::uint32_t read_le32(std::uint8_t const* data)
+    {
+        // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        return static_cast<std::uint32_t>(data[0]) | (data[1] << 8U) | (data[2] << 16U)
+               | (static_cast<std::uint32_t>(data[3]) << 24U);
+        // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    }
+
+    std::optional<rad::ImageHeader> read_png_header(std::uint8_t const* data,
+                                                    std::size_t size)
+    {
+        // Signature (8) + chunk length (4) + "IHDR" (4) + width (4) + height (4) +
+        // bit depth (1) + colour type (1).
+        static constexpr std::size_t ihdr_size{26};
+        if (size < ihdr_size)
+        {
+            return {};
+        }
+
+        // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        const int bit_depth   = data[24];
+        const int colour_type = data[25];
+        int channels{0};
+        switch (colour_type)
+        {
+        case 0:
+            channels = 1;
+            break;
+
+        case 4:
+            channels = 2;
+            break;
+
+        case 6:
+            channels = 4;
+            break;
+
+        default:
+            // Both RGB and palette images decode to three channels.
+            channels = 3;
+            break;
+        }
+
+        return rad::ImageHeader{.width    = static_cast<int>(read_be32(data + 16)),
+                                .height   = static_cast<int>(read_be32(data + 20)),
+                                .channels = channels,
+                                .depth    = bit_depth == 16 ? CV_16U : CV_8U,
+                                .format   = rad::ImageFormat::png};
+        // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    }
+
+    std::optional<rad::ImageHeader> read_bmp_header(std::uint8_t const* data,
+                                                    std::size_t size)
+    {
+        // File header (14) + info header size (4) + width (4) + height (4) + planes (2)
+        // + bits per pixel (2).
+        static constexpr std::size_t info_size{30};
+        if (size < info_size)
+        {
+            return {};
+        }
+
+        // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        const auto width  = static_cast<std::int32_t>(read_le32(data + 18));
+        const auto height = static_cast<std::int32_t>(read_le32(data + 22));
+        const int bpp     = data[28] | (data[29] << 8);
+        // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+        return rad::ImageHeader{.width    = std::abs(width),
+                                .height   = std::abs(height),
+                                .channels = bpp == 32 ? 4 : 3,
+                                .depth    = CV_8U,
+                                .format   = rad::ImageFormat::bmp};
+    }
+
+    std::optional<rad::ImageHeader> read_jpeg_header(std::ifstream& stream)
+    {
+        // Walk the marker segments until we find a start of frame. Only the segment
+        // headers are read, so large EXIF blocks are skipped over without being read.
+        std::streamoff pos{2};
+        std::array<std::uint8_t, 8> segment{};
+        for (;;)
+        {
+            stream.seekg(pos);
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+            stream.read(reinterpret_cast<char*>(segment.data()), 4);
+            if (!stream || segment[0] != 0xFF)
+            {
+                return {};
+            }
+
+            const std::uint8_t marker = segment[1];
+            if (marker == 0xFF)
+            {
+                // Fill byte.
+                ++pos;
+                continue;
+            }
+
+            const bool standalone =
+                marker == 0x01 || marker == 0xD8 || (marker >= 0xD0 && marker <= 0xD7);
+            if (standalone)
+            {
+                pos += 2;
+                continue;
+            }
+
+            if (marker == 0xD9 || marker == 0xDA)
+            {
+                // End of image or start of scan without a frame header.
+                return {};
+            }
+
+            const bool is_sof = marker >= 0xC0 && marker <= 0xCF && marker != 0xC4
+                                && marker != 0xC8 && marker != 0xCC;
+            if (is_sof)
+            {
+                // Precision (1) + height (2) + width (2) + number of components (1).
+                std::array<std::uint8_t, 6> frame{};
+                // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+                stream.read(reinterpret_cast<char*>(frame.data()), frame.size());
+                if (!stream)
+                {
+                    return {};
+                }
+
+                return rad::ImageHeader{
+                    .width    = static_cast<int>(read_be16(frame.data() + 3)),
+                    .height   = static_cast<int>(read_be16(frame.data() + 1)),
+                    .channels = frame[5] == 1 ? 1 : 3,
+                    .depth    = CV_8U,
+                    .format   = rad::ImageFormat::jpeg};
+            }
+
+            pos += 2 + static_cast<std::streamoff>(read_be16(segment.data() + 2));
+        }
+    }
+
+    int get_reduction_factor(int flags)
+    {
+        if ((flags & cv::IMREAD_REDUCED_GRAYSCALE_8) != 0)
+        {
+            return 8;
+        }
+
+        if ((flags & cv::IMREAD_REDUCED_GRAYSCALE_4) != 0)
+        {
+            return 4;
+        }
+
+        if ((flags & cv::IMREAD_REDUCED_GRAYSCALE_2) != 0)
+        {
+            return 2;
+        }
+
+        return 1;
+    }
+
+    constexpr std::uint64_t fnv1a_offset_basis{14695981039346656037ULL};
+    constexpr std::uint64_t fnv1a_prime{1099511628211ULL};
+
+    // Reduction factors supported by imread, largest first.
+    constexpr std::array<std::pair<int, int>, 3> reduction_factors{{
+        {8, cv::IMREAD_REDUCED_GRAYSCALE_8},
+        {4, cv::IMREAD_REDUCED_GRAYSCALE_4},
+        {2, cv::IMREAD_REDUCED_GRAYSCALE_2},
+    }};
+
+    // Picks the largest reduction factor that still leaves the long edge at or above
+    // the target so the final resize only ever shrinks the image. Only JPEGs are
+    // decoded at reduced scale, rounding up; other formats are decoded in full and then
+    // resized with the size rounded down, which saves nothing and can undershoot the
+    // target, so they are left alone.
+    int get_reduced_flags(int flags, rad::ImageHeader const& header, int long_edge)
+    {
+        if (flags == cv::IMREAD_UNCHANGED || get_reduction_factor(flags) != 1
+            || header.format != rad::ImageFormat::jpeg)
+        {
+            return flags;
+        }
+
+        const int max_edge = std::max(header.width, header.height);
+        for (auto [factor, reduced] : reduction_factors)
+        {
+            if ((max_edge + factor - 1) / factor >= long_edge)
+            {
+                return flags | reduced;
+            }
+        }
+
+        return flags;
+    }
+
+    std::vector<std::size_t>
+    get_largest_first_order(std::vector<std::uintmax_t> const& sizes)
+    {
+        std::vector<std::size_t> order(sizes.size());
+        std::iota(order.begin(), order.end(), std::size_t{0});
+        std::ranges::stable_sort(order, [&sizes](std::size_t a, std::size_t b) {
+            return sizes[a] > sizes[b];
+        });
+
+        return order;
+    }
+} // namespace
+
 namespace rad
 {
     namespace fs = std::filesystem;
 
+    bool has_image_extension(fs::path const& path,
+                             std::vector<std::string> const& extensions)
+    {
+        std::string ext = path.extension().string();
+        std::ranges::transform(ext, ext.begin(), [](unsigned char c) {
+            return static_cast<char>(std::tolower(c));
+        });
+
+        return std::ranges::find(extensions, ext) != extensions.end();
+    }
+
+    bool has_image_signature(std::uint8_t const* data, std::size_t size)
+    {
+        if (has_pnm_signature(data, size))
+        {
+            return true;
+        }
+
+        return std::ranges::any_of(image_signatures, [data, size](auto const& sig) {
+            if (size < sig.offset + sig.magic.size())
+            {
+                return false;
+            }
+
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            auto const* start = data + sig.offset;
+            return std::equal(sig.magic.begin(),
+                              sig.magic.end(),
+                              start,
+                              [](char a, std::uint8_t b) {
+                                  return static_cast<std::uint8_t>(a) == b;
+                              });
+        });
+    }
+
+    bool has_image_signature(fs::path const& path)
+    {
+        std::ifstream stream{path, std::ios::binary};
+        if (!stream)
+        {
+            return false;
+        }
+
+        std::array<std::uint8_t, signature_size> header{};
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        stream.read(reinterpret_cast<char*>(header.data()), header.size());
+        return has_image_signature(header.data(),
+                                   static_cast<std::size_t>(stream.gcount()));
+    }
+
+    bool is_image_file(fs::path const& path, ImageFilter const& filter)
+    {
+        if (!filter.extensions.empty() && !has_image_extension(path, filter.extensions))
+        {
+            return false;
+        }
+
+        return !filter.check_signature || has_image_signature(path);
+    }
+
+    std::optional<ImageHeader> read_image_header(fs::path const& path)
+    {
+        std::ifstream stream{path, std::ios::binary};
+        if (!stream)
+        {
+            return {};
+        }
+
+        std::array<std::uint8_t, 32> header{};
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        stream.read(reinterpret_cast<char*>(header.data()), header.size());
+        const auto size = static_cast<std::size_t>(stream.gcount());
+        stream.clear();
+
+        if (size >= 3 && header[0] == 0xFF && header[1] == 0xD8 && header[2] == 0xFF)
+        {
+            return read_jpeg_header(stream);
+        }
+
+        if (size >= 8 && header[0] == 0x89 && header[1] == 'P' && header[2] == 'N'
+            && header[3] == 'G')
+        {
+            return read_png_header(header.data(), size);
+        }
+
+        if (size >= 2 && header[0] == 'B' && header[1] == 'M')
+        {
+            return read_bmp_header(header.data(), size);
+        }
+
+        return {};
+    }
+
+    std::size_t estimate_decoded_size(fs::path const& path, int flags)
+    {
+        auto header = read_image_header(path);
+        if (!header)
+        {
+            std::error_code ec;
+            const auto file_size = fs::file_size(path, ec);
+            return ec ? 0
+                      : static_cast<std::size_t>(file_size * unknown_format_expansion);
+        }
+
+        int channels = header->channels;
+        int depth    = header->depth;
+        if (flags != cv::IMREAD_UNCHANGED)
+        {
+            if ((flags & cv::IMREAD_ANYCOLOR) == 0)
+            {
+                channels = (flags & cv::IMREAD_COLOR) != 0 ? 3 : 1;
+            }
+
+            if ((flags & cv::IMREAD_ANYDEPTH) == 0)
+            {
+                depth = CV_8U;
+            }
+        }
+
+        const int factor =
+            flags == cv::IMREAD_UNCHANGED ? 1 : get_reduction_factor(flags);
+        const auto width =
+            static_cast<std::size_t>((header->width + factor - 1) / factor);
+        const auto height =
+            static_cast<std::size_t>((header->height + factor - 1) / factor);
+        const std::size_t depth_size = depth == CV_16U ? 2 : 1;
+        return width * height * static_cast<std::size_t>(channels) * depth_size;
+    }
+
     std::vector<std::filesystem::path> get_file_paths_from_root(std::string const& root)
     {
         std::vector<fs::path> files;
@@ -27,9 +439,205 @@ namespace rad
         return files;
     }
 
+    std::vector<std::filesystem::path>
+    get_file_paths_from_root(std::string const& root, ImageFilter const& filter)
+    {
+        std::vector<fs::path> files;
+        for (auto const& entry : fs::directory_iterator{root})
+        {
+            if (!entry.is_directory() && is_image_file(entry.path(), filter))
+            {
+                files.push_back(entry.path());
+            }
+        }
+
+        return files;
+    }
+
+    std::vector<std::uintmax_t> get_file_sizes(std::vector<fs::path> const& files)
+    {
+        std::vector<std::uintmax_t> sizes(files.size(), 0);
+        oneapi::tbb::parallel_for(std::size_t{0}, files.size(), [&](std::size_t i) {
+            std::error_code ec;
+            const auto size = fs::file_size(files[i], ec);
+            sizes[i]        = ec ? 0 : size;
+        });
+
+        return sizes;
+    }
+
+    std::vector<fs::path> sort_by_file_size(std::vector<fs::path> const& files)
+    {
+        const auto sizes = get_file_sizes(files);
+        const auto order = get_largest_first_order(sizes);
+
+        std::vector<fs::path> sorted;
+        sorted.reserve(files.size());
+        for (auto i : order)
+        {
+            sorted.push_back(files[i]);
+        }
+
+        return sorted;
+    }
+
+    std::vector<std::vector<fs::path>>
+    partition_by_file_size(std::vector<fs::path> const& files, std::size_t num_chunks)
+    {
+        if (num_chunks == 0)
+        {
+            throw std::runtime_error{"error: number of chunks must be greater than 0"};
+        }
+
+        num_chunks = std::min(num_chunks, files.size());
+        std::vector<std::vector<fs::path>> chunks(num_chunks);
+        if (num_chunks == 0)
+        {
+            return chunks;
+        }
+
+        // Greedy longest-processing-time assignment: take the files from largest to
+        // smallest and always give the next one to the chunk with the smallest total.
+        const auto sizes = get_file_sizes(files);
+        const auto order = get_largest_first_order(sizes);
+
+        using ChunkLoad = std::pair<std::uintmax_t, std::size_t>;
+        std::priority_queue<ChunkLoad, std::vector<ChunkLoad>, std::greater<>> loads;
+        for (std::size_t i{0}; i < num_chunks; ++i)
+        {
+            loads.emplace(0, i);
+        }
+
+        for (auto i : order)
+        {
+            auto [load, chunk] = loads.top();
+            loads.pop();
+            chunks[chunk].push_back(files[i]);
+            loads.emplace(load + sizes[i], chunk);
+        }
+
+        return chunks;
+    }
+
+    std::uint64_t fnv1a_hash(std::string_view str)
+    {
+        std::uint64_t hash{fnv1a_offset_basis};
+        for (const char c : str)
+        {
+            hash ^= static_cast<std::uint8_t>(c);
+            hash *= fnv1a_prime;
+        }
+
+        return hash;
+    }
+
+    bool
+    is_in_shard(fs::path const& path, fs::path const& root, ShardSpec const& shard)
+    {
+        // Hash the relative path with forward slashes so every platform and every
+        // mount point of the same dataset agrees on which shard a file belongs to.
+        const auto relative = path.lexically_relative(root).generic_u8string();
+        const std::string_view bytes{
+            reinterpret_cast<char const*>(relative.data()), // NOLINT
+            relative.size()};
+        return fnv1a_hash(bytes) % shard.count == shard.index;
+    }
+
+    std::vector<fs::path> select_shard(std::vector<fs::path> const& files,
+                                       std::string const& root,
+                                       ShardSpec const& shard)
+    {
+        if (shard.count == 0)
+        {
+            throw std::runtime_error{"error: shard count must be greater than 0"};
+        }
+
+        if (shard.index >= shard.count)
+        {
+            throw std::runtime_error{fmt::format(
+                "error: shard index {} is out of range for {} shards",
+                shard.index,
+                shard.count)};
+        }
+
+        const fs::path root_path{root};
+        std::vector<fs::path> selected;
+        for (auto const& file : files)
+        {
+            if (is_in_shard(file, root_path, shard))
+            {
+                selected.push_back(file);
+            }
+        }
+
+        return selected;
+    }
+
+    std::vector<std::uint8_t> read_file_bytes(std::string const& path)
+    {
+        const profiling::StageTimer timer{profiling::Stage::read};
+        std::ifstream stream{path, std::ios::binary | std::ios::ate};
+        if (!stream)
+        {
+            throw std::runtime_error{fmt::format("error: unable to open file {}", path)};
+        }
+
+        const auto size = static_cast<std::size_t>(stream.tellg());
+        std::vector<std::uint8_t> bytes(size);
+        stream.seekg(0);
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        stream.read(reinterpret_cast<char*>(bytes.data()),
+                    static_cast<std::streamsize>(size));
+        if (!stream)
+        {
+            throw std::runtime_error{fmt::format("error: unable to read file {}", path)};
+        }
+
+        profiling::record_bytes(bytes.size());
+        return bytes;
+    }
+
+    cv::Mat decode_image(std::vector<std::uint8_t> const& buffer, int flags)
+    {
+        return decode_image(buffer.data(), buffer.size(), flags);
+    }
+
+    cv::Mat decode_image(std::uint8_t const* data, std::size_t size, int flags)
+    {
+        const profiling::StageTimer timer{profiling::Stage::decode};
+        if (size == 0)
+        {
+            return {};
+        }
+
+        // cv::Mat can't describe a buffer longer than an int.
+        if (size > static_cast<std::size_t>(std::numeric_limits<int>::max()))
+        {
+            throw std::runtime_error{fmt::format(
+                "error: cannot decode a buffer of {} bytes, the limit is {} bytes",
+                size,
+                std::numeric_limits<int>::max())};
+        }
+
+        // Wrap the bytes in a header so imdecode reads them in place.
+        const cv::Mat buffer{1,
+                             static_cast<int>(size),
+                             CV_8U,
+                             const_cast<std::uint8_t*>(data)}; // NOLINT
+        return cv::imdecode(buffer, flags);
+    }
+
     std::pair<std::string, cv::Mat> load_image(std::string const& path, int flags)
     {
+        const profiling::StageTimer timer{profiling::Stage::load};
         const fs::path entry{path};
+        if constexpr (profiling::is_enabled())
+        {
+            std::error_code ec;
+            const auto size = fs::file_size(entry, ec);
+            profiling::record_bytes(ec ? 0 : size);
+        }
+
         return {entry.stem().string(), cv::imread(entry.string(), flags)};
     }
 
@@ -38,6 +646,87 @@ namespace rad
         return load_image(path, cv::IMREAD_COLOR);
     }
 
+    std::pair<std::string, cv::Mat>
+    load_image(std::string const& path, int flags, ImageFilter const& filter)
+    {
+        const fs::path entry{path};
+        if (!is_image_file(entry, filter))
+        {
+            return {entry.stem().string(), cv::Mat{}};
+        }
+
+        return load_image(path, flags);
+    }
+
+    std::pair<std::string, cv::Mat>
+    load_image(std::string const& path, int flags, ImageReadMode mode)
+    {
+        if (mode == ImageReadMode::imread)
+        {
+            return load_image(path, flags);
+        }
+
+        // Files that can't be mapped give an empty image, the same as imread does for
+        // files it can't open.
+        const fs::path entry{path};
+        std::optional<MappedFile> file;
+        try
+        {
+            file.emplace(entry);
+        }
+        catch (std::runtime_error const&)
+        {
+            return {entry.stem().string(), cv::Mat{}};
+        }
+
+        profiling::record_bytes(file->size());
+        auto img = decode_image(file->data(), file->size(), flags);
+        file->unmap();
+        return {entry.stem().string(), img};
+    }
+
+    std::pair<std::string, cv::Mat>
+    load_image(std::string const& path, int flags, int long_edge)
+    {
+        if (long_edge <= 0)
+        {
+            throw std::runtime_error{"error: long edge must be greater than 0"};
+        }
+
+        int reduced_flags = flags;
+        if (auto header = read_image_header(path))
+        {
+            reduced_flags = get_reduced_flags(flags, *header, long_edge);
+        }
+
+        auto [name, img] = load_image(path, reduced_flags);
+        if (img.empty())
+        {
+            return {name, img};
+        }
+
+        return {name, downscale_by_long_edge(img, long_edge)};
+    }
+
+    std::pair<std::string, cv::Mat>
+    load_image(std::string const& path, int flags, ImageCache& cache)
+    {
+        auto key = ImageCache::get_key(path, flags);
+        if (!key)
+        {
+            return load_image(path, flags);
+        }
+
+        if (auto img = cache.find(*key))
+        {
+            return {fs::path{path}.stem().string(), *img};
+        }
+
+        auto [name, img] = load_image(path, flags);
+        cache.insert(*key, img);
+        return {name, img};
+    }
+
     void create_result_dir(std::string const& root, std::string const& app_name)
     {
         fs::create_directories(root);
@@ -56,6 +745,7 @@ namespace rad
             return;
         }
 
+        const profiling::StageTimer timer{profiling::Stage::save};
         cv::Mat result;
         if (img.channels() == 1)
         {
@@ -75,6 +765,11 @@ namespace rad
 
         const std::string res_root = root + "/" + app_name + "/";
         const std::string path     = res_root + img_name;
+
+        // The file may be a hard link into a result cache, so it has to be unlinked
+        // rather than truncated by imwrite.
+        std::error_code ec;
+        fs::remove(path, ec);
         cv::imwrite(path, result);
     }
 
@@ -0,0 +1,224 @@
+#include "rad/profiling.hpp"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+    using namespace rad::profiling;
+    using Clock = std::chrono::steady_clock;
+
+    // Samples are only ever appended by the thread that owns them, so the mutex is
+    // uncontended except while a summary is being built or the samples are reset.
+    struct ThreadSamples
+    {
+        std::mutex mutex;
+        std::array<std::vector<std::chrono::nanoseconds>, num_stages> samples;
+        std::uint64_t bytes_read{0};
+    };
+
+    struct Registry
+    {
+        std::mutex mutex;
+        std::vector<std::shared_ptr<ThreadSamples>> threads;
+        Clock::time_point start{Clock::now()};
+    };
+
+    Registry& get_registry()
+    {
+        static Registry registry;
+        return registry;
+    }
+
+    [[maybe_unused]] ThreadSamples& get_thread_samples()
+    {
+        thread_local const std::shared_ptr<ThreadSamples> samples = [] {
+            auto ptr       = std::make_shared<ThreadSamples>();
+            auto& registry = get_registry();
+            const std::scoped_lock lock{registry.mutex};
+            registry.threads.push_back(ptr);
+            return ptr;
+        }();
+
+        return *samples;
+    }
+
+    std::chrono::nanoseconds
+    get_percentile(std::vector<std::chrono::nanoseconds> const& sorted, double percentile)
+    {
+        const auto rank = static_cast<std::size_t>(
+            percentile * static_cast<double>(sorted.size() - 1) + 0.5);
+        return sorted[std::min(rank, sorted.size() - 1)];
+    }
+
+    StageSummary summarise(std::vector<std::chrono::nanoseconds>& samples)
+    {
+        StageSummary summary;
+        if (samples.empty())
+        {
+            return summary;
+        }
+
+        std::sort(samples.begin(), samples.end());
+        summary.count = samples.size();
+        for (auto sample : samples)
+        {
+            summary.total += sample;
+        }
+
+        summary.p50 = get_percentile(samples, 0.5);
+        summary.p90 = get_percentile(samples, 0.9);
+        summary.p99 = get_percentile(samples, 0.99);
+        summary.max = samples.back();
+        return summary;
+    }
+
+    constexpr std::array<std::string_view, num_stages> stage_names{
+        "load",
+        "read",
+        "decode",
+        "process",
+        "save",
+    };
+
+    double to_ms(std::chrono::nanoseconds ns)
+    {
+        return std::chrono::duration<double, std::milli>{ns}.count();
+    }
+} // namespace
+
+namespace rad::profiling
+{
+#if defined(RAD_PROFILING_ENABLED)
+    StageTimer::StageTimer(Stage stage) :
+        m_stage{stage},
+        m_start{Clock::now()}
+    {}
+
+    StageTimer::~StageTimer()
+    {
+        const auto elapsed = Clock::now() - m_start;
+        auto& samples      = get_thread_samples();
+        const std::scoped_lock lock{samples.mutex};
+        samples.samples[static_cast<std::size_t>(m_stage)].push_back(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed));
+    }
+
+    void record_bytes(std::uint64_t bytes)
+    {
+        auto& samples = get_thread_samples();
+        const std::scoped_lock lock{samples.mutex};
+        samples.bytes_read += bytes;
+    }
+#endif
+
+    void reset()
+    {
+        auto& registry = get_registry();
+        const std::scoped_lock lock{registry.mutex};
+        for (auto& thread : registry.threads)
+        {
+            const std::scoped_lock thread_lock{thread->mutex};
+            for (auto& samples : thread->samples)
+            {
+                samples.clear();
+            }
+
+            thread->bytes_read = 0;
+        }
+
+        registry.start = Clock::now();
+    }
+
+    Summary get_summary()
+    {
+        std::array<std::vector<std::chrono::nanoseconds>, num_stages> all_samples;
+        Summary summary;
+
+        auto& registry = get_registry();
+        {
+            const std::scoped_lock lock{registry.mutex};
+            for (auto& thread : registry.threads)
+            {
+                const std::scoped_lock thread_lock{thread->mutex};
+                for (std::size_t i{0}; i < num_stages; ++i)
+                {
+                    all_samples[i].insert(all_samples[i].end(),
+                                          thread->samples[i].begin(),
+                                          thread->samples[i].end());
+                }
+
+                summary.bytes_read += thread->bytes_read;
+            }
+
+            summary.wall_time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                Clock::now() - registry.start);
+        }
+
+        for (std::size_t i{0}; i < num_stages; ++i)
+        {
+            summary.stages[i] = summarise(all_samples[i]);
+        }
+
+        // Images are either loaded in one go or decoded from a buffer, never both.
+        summary.num_images = summary[Stage::load].count + summary[Stage::decode].count;
+
+        const auto seconds =
+            std::chrono::duration<double>{summary.wall_time}.count();
+        if (seconds > 0.0)
+        {
+            summary.images_per_second = static_cast<double>(summary.num_images) / seconds;
+            summary.bytes_per_second  = static_cast<double>(summary.bytes_read) / seconds;
+        }
+
+        return summary;
+    }
+
+    std::string format_summary(Summary const& summary)
+    {
+        std::string out = fmt::format("{:<8} {:>8} {:>12} {:>10} {:>10} {:>10} {:>10}\n",
+                                      "stage",
+                                      "count",
+                                      "total (ms)",
+                                      "p50 (ms)",
+                                      "p90 (ms)",
+                                      "p99 (ms)",
+                                      "max (ms)");
+        for (std::size_t i{0}; i < num_stages; ++i)
+        {
+            auto const& stage = summary.stages[i];
+            if (stage.count == 0)
+            {
+                continue;
+            }
+
+            out += fmt::format(
+                "{:<8} {:>8} {:>12.3f} {:>10.3f} {:>10.3f} {:>10.3f} {:>10.3f}\n",
+                stage_names[i],
+                stage.count,
+                to_ms(stage.total),
+                to_ms(stage.p50),
+                to_ms(stage.p90),
+                to_ms(stage.p99),
+                to_ms(stage.max));
+        }
+
+        out += fmt::format("images: {} ({:.2f} images/s)\n",
+                           summary.num_images,
+                           summary.images_per_second);
+        out += fmt::format("bytes read: {} ({:.2f} MB/s)\n",
+                           summary.bytes_read,
+                           summary.bytes_per_second / (1024.0 * 1024.0));
+        return out;
+    }
+} // namespace rad::profiling
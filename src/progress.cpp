@@ -0,0 +1,135 @@
+#include "rad/progress.hpp"
+
+#include <oneapi/tbb/task_arena.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace
+{
+    std::size_t get_num_counters()
+    {
+        return static_cast<std::size_t>(
+            std::max(oneapi::tbb::this_task_arena::max_concurrency(), 1));
+    }
+} // namespace
+
+namespace rad
+{
+    ProgressContext::ProgressContext() :
+        ProgressContext{nullptr, default_interval}
+    {}
+
+    ProgressContext::ProgressContext(ProgressCallback callback) :
+        ProgressContext{std::move(callback), default_interval}
+    {}
+
+    ProgressContext::ProgressContext(ProgressCallback callback,
+                                     std::chrono::milliseconds interval) :
+        m_callback{std::move(callback)},
+        m_interval{interval},
+        m_num_counters{get_num_counters()},
+        // NOLINTNEXTLINE(modernize-avoid-c-arrays)
+        m_counters{std::make_unique<Counters[]>(m_num_counters)}
+    {}
+
+    ProgressContext::~ProgressContext() = default;
+
+    void ProgressContext::cancel()
+    {
+        m_cancelled.store(true, std::memory_order_relaxed);
+    }
+
+    bool ProgressContext::is_cancelled() const
+    {
+        return m_cancelled.load(std::memory_order_relaxed);
+    }
+
+    void ProgressContext::start(std::size_t total)
+    {
+        m_total.store(total, std::memory_order_relaxed);
+        m_last_report.store(std::chrono::steady_clock::now().time_since_epoch().count(),
+                            std::memory_order_relaxed);
+    }
+
+    void ProgressContext::finish()
+    {
+        report();
+    }
+
+    void ProgressContext::record_processed(std::uint64_t bytes_read)
+    {
+        auto& counters = local_counters();
+        counters.processed.fetch_add(1, std::memory_order_relaxed);
+        counters.bytes_read.fetch_add(bytes_read, std::memory_order_relaxed);
+        maybe_report();
+    }
+
+    void ProgressContext::record_failed()
+    {
+        local_counters().failed.fetch_add(1, std::memory_order_relaxed);
+        maybe_report();
+    }
+
+    ProgressSnapshot ProgressContext::snapshot() const
+    {
+        ProgressSnapshot snapshot;
+        snapshot.total = m_total.load(std::memory_order_relaxed);
+        for (std::size_t i{0}; i < m_num_counters; ++i)
+        {
+            auto const& counters = m_counters[i];
+            snapshot.processed += counters.processed.load(std::memory_order_relaxed);
+            snapshot.failed += counters.failed.load(std::memory_order_relaxed);
+            snapshot.bytes_read += counters.bytes_read.load(std::memory_order_relaxed);
+        }
+
+        const auto done    = snapshot.processed + snapshot.failed;
+        snapshot.remaining = snapshot.total > done ? snapshot.total - done : 0;
+        return snapshot;
+    }
+
+    ProgressContext::Counters& ProgressContext::local_counters()
+    {
+        // Threads outside of the TBB arena all share the first slot.
+        const int index = oneapi::tbb::this_task_arena::current_thread_index();
+        const auto slot =
+            index < 0 ? 0 : static_cast<std::size_t>(index) % m_num_counters;
+        return m_counters[slot];
+    }
+
+    void ProgressContext::maybe_report()
+    {
+        if (!m_callback)
+        {
+            return;
+        }
+
+        const auto now = std::chrono::steady_clock::now().time_since_epoch().count();
+        auto last      = m_last_report.load(std::memory_order_relaxed);
+        if (now - last < m_interval.count())
+        {
+            return;
+        }
+
+        // Only the thread that wins the exchange reports, everyone else carries on.
+        if (m_last_report.compare_exchange_strong(last, now, std::memory_order_relaxed))
+        {
+            report();
+        }
+    }
+
+    void ProgressContext::report()
+    {
+        if (m_callback)
+        {
+            const std::scoped_lock lock{m_callback_mutex};
+            m_callback(snapshot());
+        }
+    }
+} // namespace rad
@@ -0,0 +1,216 @@
+#include "rad/result_cache.hpp"
+
+#include "rad/mapped_file.hpp"
+
+#include <fmt/format.h>
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    constexpr std::uint64_t prime1{0x9E3779B185EBCA87ULL};
+    constexpr std::uint64_t prime2{0xC2B2AE3D27D4EB4FULL};
+    constexpr std::uint64_t prime3{0x165667B19E3779F9ULL};
+    constexpr std::uint64_t prime4{0x85EBCA77C2B2AE63ULL};
+    constexpr std::uint64_t prime5{0x27D4EB2F165667C5ULL};
+
+    // Reads are assembled byte by byte so the hash is the same on any endianness.
+    std::uint64_t read_u64(std::uint8_t const* ptr)
+    {
+        std::uint64_t value{0};
+        for (int i{7}; i >= 0; --i)
+        {
+            value = (value << 8) | ptr[i];
+        }
+
+        return value;
+    }
+
+    std::uint64_t read_u32(std::uint8_t const* ptr)
+    {
+        std::uint64_t value{0};
+        for (int i{3}; i >= 0; --i)
+        {
+            value = (value << 8) | ptr[i];
+        }
+
+        return value;
+    }
+
+    std::uint64_t hash_round(std::uint64_t acc, std::uint64_t input)
+    {
+        acc += input * prime2;
+        acc = std::rotl(acc, 31);
+        return acc * prime1;
+    }
+
+    std::uint64_t merge_round(std::uint64_t acc, std::uint64_t value)
+    {
+        acc ^= hash_round(0, value);
+        return (acc * prime1) + prime4;
+    }
+
+    void link_or_copy(fs::path const& from, fs::path const& to)
+    {
+        std::error_code ec;
+        fs::create_hard_link(from, to, ec);
+        if (ec)
+        {
+            fs::copy_file(from, to, fs::copy_options::overwrite_existing);
+        }
+    }
+} // namespace
+
+namespace rad
+{
+    std::uint64_t xxhash64(std::uint8_t const* data, std::size_t size, std::uint64_t seed)
+    {
+        std::uint8_t const* ptr = data;
+        std::uint8_t const* end = data + size;
+
+        std::uint64_t hash{0};
+        if (size >= 32)
+        {
+            std::uint64_t v1 = seed + prime1 + prime2;
+            std::uint64_t v2 = seed + prime2;
+            std::uint64_t v3 = seed;
+            std::uint64_t v4 = seed - prime1;
+
+            while (end - ptr >= 32)
+            {
+                v1 = hash_round(v1, read_u64(ptr));
+                v2 = hash_round(v2, read_u64(ptr + 8));
+                v3 = hash_round(v3, read_u64(ptr + 16));
+                v4 = hash_round(v4, read_u64(ptr + 24));
+                ptr += 32;
+            }
+
+            hash = std::rotl(v1, 1) + std::rotl(v2, 7) + std::rotl(v3, 12)
+                   + std::rotl(v4, 18);
+            hash = merge_round(hash, v1);
+            hash = merge_round(hash, v2);
+            hash = merge_round(hash, v3);
+            hash = merge_round(hash, v4);
+        }
+        else
+        {
+            hash = seed + prime5;
+        }
+
+        hash += static_cast<std::uint64_t>(size);
+
+        while (end - ptr >= 8)
+        {
+            hash ^= hash_round(0, read_u64(ptr));
+            hash = (std::rotl(hash, 27) * prime1) + prime4;
+            ptr += 8;
+        }
+
+        if (end - ptr >= 4)
+        {
+            hash ^= read_u32(ptr) * prime1;
+            hash = (std::rotl(hash, 23) * prime2) + prime3;
+            ptr += 4;
+        }
+
+        while (ptr < end)
+        {
+            hash ^= *ptr * prime5;
+            hash = std::rotl(hash, 11) * prime1;
+            ++ptr;
+        }
+
+        hash ^= hash >> 33;
+        hash *= prime2;
+        hash ^= hash >> 29;
+        hash *= prime3;
+        hash ^= hash >> 32;
+        return hash;
+    }
+
+    std::uint64_t xxhash64(std::string_view str, std::uint64_t seed)
+    {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        return xxhash64(reinterpret_cast<std::uint8_t const*>(str.data()),
+                        str.size(),
+                        seed);
+    }
+
+    ResultCache::ResultCache(fs::path const& root, std::string const& version) :
+        m_root{root},
+        m_seed{xxhash64(version, 0)}
+    {
+        fs::create_directories(m_root);
+    }
+
+    std::uint64_t ResultCache::get_key(fs::path const& input) const
+    {
+        const MappedFile file{input};
+        return xxhash64(file.data(), file.size(), m_seed);
+    }
+
+    std::uint64_t ResultCache::get_key(fs::path const& input,
+                                       std::string_view context) const
+    {
+        const MappedFile file{input};
+        return xxhash64(file.data(), file.size(), xxhash64(context, m_seed));
+    }
+
+    bool ResultCache::restore(std::uint64_t key, fs::path const& destination)
+    {
+        const auto entry = get_entry_path(key);
+        if (!fs::exists(entry))
+        {
+            return false;
+        }
+
+        fs::remove(destination);
+        link_or_copy(entry, destination);
+        ++m_num_hits;
+        return true;
+    }
+
+    void ResultCache::store(std::uint64_t key, fs::path const& result)
+    {
+        // Write under a unique temporary name first so a concurrent restore never sees
+        // a partially copied entry.
+        const auto entry = get_entry_path(key);
+        fs::create_directories(entry.parent_path());
+        const auto temp =
+            entry.parent_path() / fmt::format(".{:016x}.{}.tmp", key, m_next_temp++);
+        fs::copy_file(result, temp, fs::copy_options::overwrite_existing);
+        fs::rename(temp, entry);
+        ++m_num_stores;
+    }
+
+    fs::path const& ResultCache::root() const
+    {
+        return m_root;
+    }
+
+    std::size_t ResultCache::num_hits() const
+    {
+        return m_num_hits;
+    }
+
+    std::size_t ResultCache::num_stores() const
+    {
+        return m_num_stores;
+    }
+
+    fs::path ResultCache::get_entry_path(std::uint64_t key) const
+    {
+        // Fan the entries out over subdirectories so no single directory grows too
+        // large on big datasets.
+        const auto name = fmt::format("{:016x}", key);
+        return m_root / name.substr(0, 2) / name;
+    }
+} // namespace rad
@@ -0,0 +1,312 @@
+#include "rad/tar_archive.hpp"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    constexpr std::size_t block_size{512};
+
+    // Offsets and sizes of the header fields that are used.
+    constexpr std::size_t name_offset{0};
+    constexpr std::size_t name_size{100};
+    constexpr std::size_t size_offset{124};
+    constexpr std::size_t size_size{12};
+    constexpr std::size_t checksum_offset{148};
+    constexpr std::size_t checksum_size{8};
+    constexpr std::size_t type_offset{156};
+    constexpr std::size_t magic_offset{257};
+    constexpr std::size_t prefix_offset{345};
+    constexpr std::size_t prefix_size{155};
+
+    std::size_t round_to_block(std::size_t size)
+    {
+        return (size + block_size - 1) / block_size * block_size;
+    }
+
+    std::string_view get_string(std::uint8_t const* header,
+                                std::size_t offset,
+                                std::size_t size)
+    {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        const std::string_view field{reinterpret_cast<char const*>(header + offset),
+                                     size};
+        return field.substr(0, field.find('\0'));
+    }
+
+    std::size_t
+    get_number(std::uint8_t const* header, std::size_t offset, std::size_t size)
+    {
+        // GNU tar stores values that don't fit in the octal field as big-endian
+        // base-256, flagged by the high bit of the first byte.
+        if ((header[offset] & 0x80) != 0)
+        {
+            std::size_t value = header[offset] & 0x7F;
+            for (std::size_t i{1}; i < size; ++i)
+            {
+                if (value > (std::numeric_limits<std::size_t>::max() >> 8))
+                {
+                    throw std::runtime_error{"error: tar header value out of range"};
+                }
+
+                value = (value << 8) | header[offset + i];
+            }
+
+            return value;
+        }
+
+        std::size_t value{0};
+        for (std::size_t i{0}; i < size; ++i)
+        {
+            const auto c = header[offset + i];
+            if (c == ' ' && value == 0)
+            {
+                continue;
+            }
+
+            if (c < '0' || c > '7')
+            {
+                break;
+            }
+
+            value = (value * 8) + (c - '0');
+        }
+
+        return value;
+    }
+
+    bool is_zero_block(std::uint8_t const* header)
+    {
+        return std::all_of(header, header + block_size, [](std::uint8_t c) {
+            return c == 0;
+        });
+    }
+
+    bool is_valid_checksum(std::uint8_t const* header)
+    {
+        // The checksum is computed with its own field treated as spaces.
+        std::size_t sum{0};
+        for (std::size_t i{0}; i < block_size; ++i)
+        {
+            const bool in_field =
+                i >= checksum_offset && i < checksum_offset + checksum_size;
+            sum += in_field ? ' ' : header[i];
+        }
+
+        return sum == get_number(header, checksum_offset, checksum_size);
+    }
+
+    // Headers that only carry metadata for the header that follows them.
+    bool is_extension_header(char type)
+    {
+        return type == 'L' || type == 'K' || type == 'x' || type == 'g';
+    }
+
+    struct PaxOverrides
+    {
+        std::optional<std::string> path;
+        std::optional<std::size_t> size;
+    };
+
+    // Parses the records of a pax extended header, which have the form
+    // "<length> <key>=<value>\n" where length covers the whole record.
+    PaxOverrides parse_pax(std::string_view records)
+    {
+        PaxOverrides overrides;
+        while (!records.empty())
+        {
+            const auto space = records.find(' ');
+            std::size_t length{0};
+            if (space == std::string_view::npos
+                || std::from_chars(records.data(), records.data() + space, length).ec
+                       != std::errc{}
+                || length <= space || length > records.size())
+            {
+                throw std::runtime_error{"error: malformed pax header"};
+            }
+
+            // Drop the trailing newline.
+            const auto record = records.substr(space + 1, length - space - 2);
+            const auto equals = record.find('=');
+            if (equals != std::string_view::npos)
+            {
+                const auto key   = record.substr(0, equals);
+                const auto value = record.substr(equals + 1);
+                if (key == "path")
+                {
+                    overrides.path = std::string{value};
+                }
+                else if (key == "size")
+                {
+                    std::size_t size{0};
+                    const auto result =
+                        std::from_chars(value.data(), value.data() + value.size(), size);
+                    if (result.ec != std::errc{}
+                        || result.ptr != value.data() + value.size())
+                    {
+                        throw std::runtime_error{"error: malformed pax header"};
+                    }
+
+                    overrides.size = size;
+                }
+            }
+
+            records.remove_prefix(length);
+        }
+
+        return overrides;
+    }
+} // namespace
+
+namespace rad
+{
+    TarArchive::TarArchive(fs::path const& path) :
+        m_path{path},
+        m_file{path}
+    {
+        build_index();
+    }
+
+    std::vector<TarMember> const& TarArchive::members() const
+    {
+        return m_members;
+    }
+
+    std::uint8_t const* TarArchive::data(TarMember const& member) const
+    {
+        return m_file.data() + member.offset;
+    }
+
+    fs::path const& TarArchive::path() const
+    {
+        return m_path;
+    }
+
+    void TarArchive::build_index()
+    {
+        auto throw_truncated = [this] {
+            throw std::runtime_error{
+                fmt::format("error: archive {} is truncated", m_path.string())};
+        };
+
+        std::uint8_t const* base    = m_file.data();
+        const std::size_t file_size = m_file.size();
+
+        // Name and size overrides that apply to the next header only.
+        PaxOverrides pending;
+
+        std::size_t pos{0};
+        while (pos + block_size <= file_size)
+        {
+            std::uint8_t const* header = base + pos;
+            if (is_zero_block(header))
+            {
+                break;
+            }
+
+            if (!is_valid_checksum(header))
+            {
+                throw std::runtime_error{
+                    fmt::format("error: invalid tar header at offset {} in {}",
+                                pos,
+                                m_path.string())};
+            }
+
+            const char type   = static_cast<char>(header[type_offset]);
+            std::size_t size  = get_number(header, size_offset, size_size);
+            const auto offset = pos + block_size;
+            if (!is_extension_header(type) && pending.size)
+            {
+                size = *pending.size;
+            }
+
+            // The loop condition guarantees offset <= file_size, so this can't wrap
+            // around the way offset + size could for a huge size field.
+            if (size > file_size - offset)
+            {
+                throw_truncated();
+            }
+
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+            const std::string_view contents{reinterpret_cast<char const*>(base + offset),
+                                            size};
+            switch (type)
+            {
+            case 'L':
+                pending.path = std::string{contents.substr(0, contents.find('\0'))};
+                break;
+
+            case 'x':
+                {
+                    auto overrides = parse_pax(contents);
+                    if (overrides.path)
+                    {
+                        pending.path = std::move(overrides.path);
+                    }
+
+                    if (overrides.size)
+                    {
+                        pending.size = overrides.size;
+                    }
+                    break;
+                }
+
+            case '0':
+            case '\0':
+            case '7':
+                {
+                    std::string name;
+                    if (pending.path)
+                    {
+                        name = std::move(*pending.path);
+                    }
+                    else
+                    {
+                        name = std::string{get_string(header, name_offset, name_size)};
+                        const auto prefix =
+                            get_string(header, prefix_offset, prefix_size);
+                        if (get_string(header, magic_offset, 5) == "ustar"
+                            && !prefix.empty())
+                        {
+                            name = fmt::format("{}/{}", prefix, name);
+                        }
+                    }
+
+                    m_members.push_back(
+                        {.name = std::move(name), .offset = offset, .size = size});
+                    break;
+                }
+
+            default:
+                // Directories, links, global pax headers and anything else that has no
+                // file contents of its own.
+                break;
+            }
+
+            if (!is_extension_header(type))
+            {
+                pending = {};
+            }
+
+            const auto next = offset + round_to_block(size);
+            if (next <= pos)
+            {
+                throw_truncated();
+            }
+
+            pos = next;
+        }
+    }
+} // namespace rad
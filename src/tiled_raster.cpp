@@ -0,0 +1,208 @@
+#include "rad/tiled_raster.hpp"
+
+#include <fmt/format.h>
+#include <opencv2/core/mat.hpp>
+#include <opencv2/core/types.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <ios>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    std::size_t get_row_bytes(rad::RasterLayout const& layout)
+    {
+        return static_cast<std::size_t>(layout.size.width) * CV_ELEM_SIZE(layout.type);
+    }
+
+    std::size_t get_raster_bytes(rad::RasterLayout const& layout)
+    {
+        return layout.offset
+               + get_row_bytes(layout) * static_cast<std::size_t>(layout.size.height);
+    }
+
+    std::size_t get_pixel_offset(rad::RasterLayout const& layout, int x, int y)
+    {
+        return layout.offset + (get_row_bytes(layout) * static_cast<std::size_t>(y))
+               + (static_cast<std::size_t>(x) * CV_ELEM_SIZE(layout.type));
+    }
+
+    void validate_layout(rad::RasterLayout const& layout)
+    {
+        if (layout.size.width <= 0 || layout.size.height <= 0)
+        {
+            throw std::runtime_error{"error: raster size must be greater than 0"};
+        }
+    }
+
+    void validate_roi(rad::RasterLayout const& layout, cv::Rect const& roi)
+    {
+        const cv::Rect bounds{0, 0, layout.size.width, layout.size.height};
+        if (roi.width <= 0 || roi.height <= 0 || (roi & bounds) != roi)
+        {
+            throw std::runtime_error{
+                fmt::format("error: region ({}, {}, {}, {}) is outside the raster",
+                            roi.x,
+                            roi.y,
+                            roi.width,
+                            roi.height)};
+        }
+    }
+} // namespace
+
+namespace rad
+{
+    std::vector<TileSpec> make_tiles(cv::Size image_size, cv::Size tile_size, int overlap)
+    {
+        if (tile_size.width <= 0 || tile_size.height <= 0)
+        {
+            throw std::runtime_error{"error: tile size must be greater than 0"};
+        }
+
+        if (overlap < 0)
+        {
+            throw std::runtime_error{"error: tile overlap cannot be negative"};
+        }
+
+        const cv::Rect bounds{0, 0, image_size.width, image_size.height};
+        std::vector<TileSpec> tiles;
+        for (int y{0}; y < image_size.height; y += tile_size.height)
+        {
+            for (int x{0}; x < image_size.width; x += tile_size.width)
+            {
+                const cv::Rect core{x,
+                                    y,
+                                    std::min(tile_size.width, image_size.width - x),
+                                    std::min(tile_size.height, image_size.height - y)};
+                const cv::Rect roi{core.x - overlap,
+                                   core.y - overlap,
+                                   core.width + (2 * overlap),
+                                   core.height + (2 * overlap)};
+                tiles.push_back({.roi = roi & bounds, .core = core});
+            }
+        }
+
+        return tiles;
+    }
+
+    RawRasterReader::RawRasterReader(fs::path const& path, RasterLayout const& layout) :
+        m_layout{layout}
+    {
+        validate_layout(m_layout);
+        // Tiles are read in whatever order the workers pick them up, and each one
+        // strides across the rows of the raster, so read-ahead would mostly pull in
+        // pixels that belong to other tiles.
+        m_file = MappedFile{path, MapMode::read_only, AccessHint::random};
+        if (m_file.size() < get_raster_bytes(m_layout))
+        {
+            throw std::runtime_error{
+                fmt::format("error: file {} is too small for a {}x{} raster",
+                            path.string(),
+                            m_layout.size.width,
+                            m_layout.size.height)};
+        }
+    }
+
+    RasterLayout const& RawRasterReader::layout() const
+    {
+        return m_layout;
+    }
+
+    cv::Mat RawRasterReader::read(cv::Rect const& roi) const
+    {
+        validate_roi(m_layout, roi);
+
+        // OpenCV has no notion of a read-only Mat, so the constness has to be cast away
+        // for the header. The mapping itself is read-only.
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+        auto* data = const_cast<std::uint8_t*>(
+            m_file.data() + get_pixel_offset(m_layout, roi.x, roi.y));
+        return {roi.size(), m_layout.type, data, get_row_bytes(m_layout)};
+    }
+
+    RawRasterWriter::RawRasterWriter(fs::path const& path, RasterLayout const& layout) :
+        m_layout{layout}
+    {
+        validate_layout(m_layout);
+
+        // Create the file at its final size up front so the tiles can be written in
+        // whatever order they finish.
+        {
+            const std::ofstream create{path, std::ios::binary | std::ios::trunc};
+            if (!create)
+            {
+                throw std::runtime_error{
+                    fmt::format("error: unable to create file {}", path.string())};
+            }
+        }
+        fs::resize_file(path, get_raster_bytes(m_layout));
+
+        m_stream.open(path, std::ios::binary | std::ios::in | std::ios::out);
+        if (!m_stream)
+        {
+            throw std::runtime_error{
+                fmt::format("error: unable to open file {}", path.string())};
+        }
+    }
+
+    RasterLayout const& RawRasterWriter::layout() const
+    {
+        return m_layout;
+    }
+
+    void RawRasterWriter::write(cv::Rect const& roi, cv::Mat const& img)
+    {
+        validate_roi(m_layout, roi);
+        if (img.size() != roi.size() || img.type() != m_layout.type)
+        {
+            throw std::runtime_error{
+                "error: image does not match the size of the region or the raster type"};
+        }
+
+        const auto row_bytes = static_cast<std::streamsize>(
+            static_cast<std::size_t>(roi.width) * CV_ELEM_SIZE(m_layout.type));
+
+        const std::scoped_lock lock{m_mutex};
+        for (int row{0}; row < roi.height; ++row)
+        {
+            m_stream.seekp(static_cast<std::streamoff>(
+                get_pixel_offset(m_layout, roi.x, roi.y + row)));
+            m_stream.write(img.ptr<char>(row), row_bytes);
+        }
+
+        if (!m_stream)
+        {
+            throw std::runtime_error{"error: unable to write raster region"};
+        }
+    }
+
+    void RawRasterWriter::write_tile(TileSpec const& tile, cv::Mat const& result)
+    {
+        if (result.size() != tile.roi.size())
+        {
+            throw std::runtime_error{"error: tile result does not match the tile size"};
+        }
+
+        // Only the core of the tile is written, so the overlapping borders that are
+        // shared with the neighbouring tiles are never written twice.
+        const cv::Rect core{tile.core.x - tile.roi.x,
+                            tile.core.y - tile.roi.y,
+                            tile.core.width,
+                            tile.core.height};
+        write(tile.core, result(core));
+    }
+
+    void RawRasterWriter::flush()
+    {
+        const std::scoped_lock lock{m_mutex};
+        m_stream.flush();
+    }
+} // namespace rad
@@ -0,0 +1,124 @@
+#include "rad/video_reader.hpp"
+
+#include <fmt/format.h>
+#include <opencv2/core/mat.hpp>
+#include <opencv2/videoio.hpp>
+
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+
+namespace rad
+{
+    VideoReader::VideoReader(std::string const& path) :
+        VideoReader{path, default_ring_size}
+    {}
+
+    VideoReader::VideoReader(std::string const& path, std::size_t ring_size) :
+        m_ring_size{ring_size}
+    {
+        if (m_ring_size == 0)
+        {
+            throw std::runtime_error{"error: ring size must be greater than 0"};
+        }
+
+        cv::VideoCapture capture{path};
+        if (!capture.isOpened())
+        {
+            throw std::runtime_error{fmt::format("error: unable to open video {}", path)};
+        }
+
+        m_decoder = std::thread{[this, capture = std::move(capture)]() mutable {
+            try
+            {
+                for (std::size_t index{0};; ++index)
+                {
+                    VideoFrame frame{.index = index, .img = {}};
+                    if (!capture.read(frame.img) || frame.img.empty()
+                        || !push(std::move(frame)))
+                    {
+                        break;
+                    }
+                }
+
+                finish(nullptr);
+            }
+            catch (...)
+            {
+                finish(std::current_exception());
+            }
+        }};
+    }
+
+    VideoReader::~VideoReader()
+    {
+        {
+            const std::scoped_lock lock{m_mutex};
+            m_stop = true;
+        }
+
+        m_space.notify_all();
+        if (m_decoder.joinable())
+        {
+            m_decoder.join();
+        }
+    }
+
+    std::optional<VideoFrame> VideoReader::next()
+    {
+        std::unique_lock lock{m_mutex};
+        m_ready.wait(lock, [this] {
+            return !m_ring.empty() || m_done;
+        });
+
+        if (m_ring.empty())
+        {
+            if (m_error)
+            {
+                std::rethrow_exception(std::exchange(m_error, nullptr));
+            }
+
+            return {};
+        }
+
+        auto frame = std::move(m_ring.front());
+        m_ring.pop_front();
+        lock.unlock();
+        m_space.notify_one();
+        return frame;
+    }
+
+    bool VideoReader::push(VideoFrame frame)
+    {
+        std::unique_lock lock{m_mutex};
+        m_space.wait(lock, [this] {
+            return m_ring.size() < m_ring_size || m_stop;
+        });
+
+        if (m_stop)
+        {
+            return false;
+        }
+
+        m_ring.push_back(std::move(frame));
+        lock.unlock();
+        m_ready.notify_one();
+        return true;
+    }
+
+    void VideoReader::finish(std::exception_ptr error)
+    {
+        {
+            const std::scoped_lock lock{m_mutex};
+            m_done  = true;
+            m_error = std::move(error);
+        }
+
+        m_ready.notify_all();
+    }
+} // namespace rad
@@ -0,0 +1,190 @@
+#include "rad/worker_arena.hpp"
+
+#include <fmt/format.h>
+#include <oneapi/tbb/enumerable_thread_specific.h>
+#include <oneapi/tbb/task_arena.h>
+#include <oneapi/tbb/task_scheduler_observer.h>
+#include <zeus/platform.hpp> // NOLINT(misc-include-cleaner)
+
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#if defined(ZEUS_PLATFORM_WINDOWS)
+#    ifndef NOMINMAX
+#        define NOMINMAX
+#    endif
+#    ifndef WIN32_LEAN_AND_MEAN
+#        define WIN32_LEAN_AND_MEAN
+#    endif
+#    include <windows.h>
+#elif defined(ZEUS_PLATFORM_LINUX)
+#    include <pthread.h>
+#    include <sched.h>
+#endif
+
+namespace
+{
+#if defined(ZEUS_PLATFORM_WINDOWS)
+    using CpuMask = DWORD_PTR;
+
+    CpuMask make_cpu_mask(std::vector<int> const& cpus)
+    {
+        CpuMask mask{0};
+        for (const int cpu : cpus)
+        {
+            if (cpu >= static_cast<int>(sizeof(CpuMask) * 8))
+            {
+                throw std::runtime_error{
+                    fmt::format("error: CPU {} is outside of the processor group", cpu)};
+            }
+
+            mask |= CpuMask{1} << cpu;
+        }
+
+        return mask;
+    }
+
+    // Returns the mask the thread had before. Windows has no way to query the mask of
+    // a thread other than setting it.
+    CpuMask set_thread_mask(CpuMask const& mask)
+    {
+        return SetThreadAffinityMask(GetCurrentThread(), mask);
+    }
+#elif defined(ZEUS_PLATFORM_LINUX)
+    using CpuMask = cpu_set_t;
+
+    CpuMask make_cpu_mask(std::vector<int> const& cpus)
+    {
+        CpuMask mask;
+        CPU_ZERO(&mask);
+        for (const int cpu : cpus)
+        {
+            if (cpu >= CPU_SETSIZE)
+            {
+                throw std::runtime_error{
+                    fmt::format("error: CPU {} is outside of the supported range", cpu)};
+            }
+
+            CPU_SET(cpu, &mask);
+        }
+
+        return mask;
+    }
+
+    // Returns the mask the thread had before.
+    CpuMask set_thread_mask(CpuMask const& mask)
+    {
+        CpuMask previous;
+        CPU_ZERO(&previous);
+        pthread_getaffinity_np(pthread_self(), sizeof(CpuMask), &previous);
+        pthread_setaffinity_np(pthread_self(), sizeof(CpuMask), &mask);
+        return previous;
+    }
+#endif
+} // namespace
+
+namespace rad
+{
+#if defined(ZEUS_PLATFORM_WINDOWS) || defined(ZEUS_PLATFORM_LINUX)
+    // Pins every thread that joins the arena to the requested CPUs and puts that
+    // thread's own mask back when it leaves, so TBB workers that later move to another
+    // arena aren't left pinned.
+    class WorkerArena::AffinityObserver : public oneapi::tbb::task_scheduler_observer
+    {
+    public:
+        AffinityObserver(oneapi::tbb::task_arena& arena, std::vector<int> const& cpus) :
+            oneapi::tbb::task_scheduler_observer{arena},
+            m_mask{make_cpu_mask(cpus)}
+        {
+            observe(true);
+        }
+
+        AffinityObserver(AffinityObserver const&) = delete;
+        AffinityObserver(AffinityObserver&&)      = delete;
+
+        ~AffinityObserver() override
+        {
+            observe(false);
+        }
+
+        AffinityObserver& operator=(AffinityObserver const&) = delete;
+        AffinityObserver& operator=(AffinityObserver&&)      = delete;
+
+        void on_scheduler_entry(bool) override
+        {
+            m_original.local() = set_thread_mask(m_mask);
+        }
+
+        void on_scheduler_exit(bool) override
+        {
+            set_thread_mask(m_original.local());
+        }
+
+    private:
+        CpuMask m_mask;
+        oneapi::tbb::enumerable_thread_specific<CpuMask> m_original;
+    };
+#else
+    class WorkerArena::AffinityObserver
+    {
+    public:
+        AffinityObserver(oneapi::tbb::task_arena&, std::vector<int> const&)
+        {}
+    };
+#endif
+
+    WorkerArena::WorkerArena(int max_concurrency) :
+        WorkerArena{max_concurrency, {}}
+    {}
+
+    WorkerArena::WorkerArena(int max_concurrency, std::vector<int> cpus) :
+        m_cpus{std::move(cpus)}
+    {
+        if (max_concurrency <= 0)
+        {
+            throw std::runtime_error{"error: max concurrency must be greater than 0"};
+        }
+
+        for (const int cpu : m_cpus)
+        {
+            if (cpu < 0)
+            {
+                throw std::runtime_error{fmt::format("error: invalid CPU index {}", cpu)};
+            }
+        }
+
+        m_arena.initialize(max_concurrency);
+        if (!m_cpus.empty() && is_affinity_supported())
+        {
+            m_observer = std::make_unique<AffinityObserver>(m_arena, m_cpus);
+        }
+    }
+
+    WorkerArena::~WorkerArena() = default;
+
+    int WorkerArena::max_concurrency() const
+    {
+        return m_arena.max_concurrency();
+    }
+
+    std::vector<int> const& WorkerArena::cpus() const
+    {
+        return m_cpus;
+    }
+
+    bool WorkerArena::is_affinity_supported()
+    {
+#if defined(ZEUS_PLATFORM_WINDOWS) || defined(ZEUS_PLATFORM_LINUX)
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    oneapi::tbb::task_arena& WorkerArena::get()
+    {
+        return m_arena;
+    }
+} // namespace rad
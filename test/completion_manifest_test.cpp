@@ -0,0 +1,86 @@
+#include <catch2/catch_test_macros.hpp>
+#include <oneapi/tbb/parallel_for.h>
+#include <rad/completion_manifest.hpp>
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace fs = std::filesystem;
+
+TEST_CASE("[completion_manifest] - CompletionManifest", "[rad]")
+{
+    const fs::path root        = fs::absolute("./test_root");
+    const std::string app_name = "app";
+
+    SECTION("Empty manifest")
+    {
+        const rad::CompletionManifest manifest{root.string(), app_name};
+        REQUIRE(manifest.path() == root / app_name / ".rad_manifest");
+        REQUIRE(fs::exists(manifest.path()));
+        REQUIRE(manifest.num_completed() == 0);
+        REQUIRE_FALSE(manifest.is_complete("img.jpg"));
+    }
+
+    SECTION("Resume")
+    {
+        {
+            rad::CompletionManifest manifest{root.string(), app_name, 2};
+            manifest.mark_complete("img_0.jpg");
+            manifest.mark_complete("img_1.jpg");
+            manifest.mark_complete("img_2.jpg");
+            REQUIRE(manifest.num_completed() == 3);
+        }
+
+        const rad::CompletionManifest manifest{root.string(), app_name};
+        REQUIRE(manifest.num_completed() == 3);
+        REQUIRE(manifest.is_complete("img_0.jpg"));
+        REQUIRE(manifest.is_complete("img_1.jpg"));
+        REQUIRE(manifest.is_complete("img_2.jpg"));
+        REQUIRE_FALSE(manifest.is_complete("img_3.jpg"));
+    }
+
+    SECTION("Concurrent writes")
+    {
+        static constexpr std::size_t num_entries{1000};
+        {
+            rad::CompletionManifest manifest{root.string(), app_name, 16};
+            oneapi::tbb::parallel_for(std::size_t{0}, num_entries, [&](std::size_t i) {
+                manifest.mark_complete(std::to_string(i));
+            });
+        }
+
+        const rad::CompletionManifest manifest{root.string(), app_name};
+        REQUIRE(manifest.num_completed() == num_entries);
+        for (std::size_t i{0}; i < num_entries; ++i)
+        {
+            REQUIRE(manifest.is_complete(std::to_string(i)));
+        }
+    }
+
+    SECTION("Truncated entry")
+    {
+        fs::create_directories(root / app_name);
+        std::ofstream{root / app_name / ".rad_manifest", std::ios::binary}
+            << "img_0.jpg\nimg_1.jpg\nimg_2.j";
+
+        {
+            rad::CompletionManifest manifest{root.string(), app_name};
+            REQUIRE(manifest.num_completed() == 2);
+            REQUIRE_FALSE(manifest.is_complete("img_2.j"));
+            manifest.mark_complete("img_2.jpg");
+        }
+
+        const rad::CompletionManifest manifest{root.string(), app_name};
+        REQUIRE(manifest.num_completed() == 3);
+        REQUIRE(manifest.is_complete("img_2.jpg"));
+    }
+
+    SECTION("Invalid threshold")
+    {
+        REQUIRE_THROWS(rad::CompletionManifest{root.string(), app_name, 0});
+    }
+
+    fs::remove_all(root);
+}
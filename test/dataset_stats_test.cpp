@@ -0,0 +1,94 @@
+#include "test_file_manager.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/format.h>
+#include <opencv2/core/hal/interface.h>
+#include <opencv2/core/mat.hpp>
+#include <opencv2/core/types.hpp>
+#include <opencv2/imgcodecs.hpp>
+#include <rad/dataset_stats.hpp>
+#include <zeus/float.hpp>
+
+#include <filesystem>
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+TEST_CASE("[dataset_stats] - compute_dataset_stats", "[rad]")
+{
+    using zeus::almost_equal;
+    static constexpr double epsilon{0.00001};
+
+    // Even files are black and odd files are white, so the dataset has a mean of 0.5
+    // and a standard deviation of 0.5 in every channel.
+    const TestFileManager::Params params{.num_files = 0};
+    const TestFileManager mgr{params};
+    static constexpr int num_files{10};
+    for (int i{0}; i < num_files; ++i)
+    {
+        const cv::Mat img{cv::Size{64, 32},
+                          CV_8UC3,
+                          cv::Scalar::all(i % 2 == 0 ? 0 : 255)};
+        cv::imwrite((mgr.root() / fmt::format("img_{:02}.png", i)).string(), img);
+    }
+
+    // Files that aren't images are skipped.
+    std::ofstream{mgr.root() / "README.txt"} << "not an image";
+
+    auto check_channels = [](cv::Scalar const& value, double expected) {
+        for (int c{0}; c < 3; ++c)
+        {
+            REQUIRE(almost_equal(value[c], expected, epsilon));
+        }
+    };
+
+    SECTION("Full dataset")
+    {
+        const auto stats = rad::compute_dataset_stats(mgr.root().string());
+        REQUIRE(stats.channels == 3);
+        REQUIRE(stats.num_images == num_files);
+        REQUIRE(stats.num_pixels == num_files * 64 * 32);
+        check_channels(stats.mean, 0.5);
+        check_channels(stats.std, 0.5);
+    }
+
+    SECTION("Subsampling")
+    {
+        const auto stats = rad::compute_dataset_stats(mgr.root().string(),
+                                                      {.sample_stride = 2});
+        REQUIRE(stats.num_images == num_files / 2);
+        check_channels(stats.mean, 0.0);
+        check_channels(stats.std, 0.0);
+    }
+
+    SECTION("Reduced resolution")
+    {
+        const auto stats =
+            rad::compute_dataset_stats(mgr.root().string(), {.long_edge = 16});
+        REQUIRE(stats.num_images == num_files);
+        REQUIRE(stats.num_pixels < num_files * 64 * 32);
+        check_channels(stats.mean, 0.5);
+        check_channels(stats.std, 0.5);
+    }
+
+    SECTION("Grayscale")
+    {
+        const auto stats = rad::compute_dataset_stats(mgr.root().string(),
+                                                      {.flags = cv::IMREAD_GRAYSCALE});
+        REQUIRE(stats.channels == 1);
+        REQUIRE(almost_equal(stats.mean[0], 0.5, epsilon));
+        REQUIRE(almost_equal(stats.std[0], 0.5, epsilon));
+    }
+
+    SECTION("Invalid arguments")
+    {
+        REQUIRE_THROWS(
+            rad::compute_dataset_stats(mgr.root().string(), {.sample_stride = 0}));
+        REQUIRE_THROWS(
+            rad::compute_dataset_stats(mgr.root().string(), {.long_edge = -1}));
+
+        const fs::path empty = mgr.root() / "empty";
+        fs::create_directories(empty);
+        REQUIRE_THROWS(rad::compute_dataset_stats(empty.string()));
+    }
+}
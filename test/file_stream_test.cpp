@@ -0,0 +1,95 @@
+#include "test_file_manager.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/format.h>
+#include <opencv2/core/mat.hpp>
+#include <opencv2/imgcodecs.hpp>
+#include <rad/file_stream.hpp>
+
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <unordered_set>
+
+namespace fs = std::filesystem;
+
+TEST_CASE("[file_stream] - FileStream", "[rad]")
+{
+    const TestFileManager::Params params;
+    const TestFileManager mgr{params};
+
+    std::unordered_set<fs::path> exp_paths;
+    for (int i{0}; i < params.num_files; ++i)
+    {
+        exp_paths.insert(mgr.root() / fmt::format("test_img_{}.jpg", i));
+    }
+
+    SECTION("Flat directory")
+    {
+        rad::FileStream stream{mgr.root().string()};
+
+        std::size_t count{0};
+        while (auto path = stream.next())
+        {
+            REQUIRE(exp_paths.find(*path) != exp_paths.end());
+            ++count;
+        }
+
+        REQUIRE(count == exp_paths.size());
+        REQUIRE_FALSE(stream.next());
+    }
+
+    SECTION("Nested directories")
+    {
+        const cv::Mat img = cv::Mat::ones(params.size, params.type);
+        for (auto const& sub : {"a", "a/b", "c"})
+        {
+            const fs::path dir = mgr.root() / sub;
+            fs::create_directories(dir);
+            const fs::path img_path = dir / "nested_img.jpg";
+            cv::imwrite(img_path.string(), img);
+            exp_paths.insert(img_path);
+        }
+
+        rad::FileStream stream{mgr.root().string()};
+
+        std::unordered_set<fs::path> seen;
+        while (auto path = stream.next())
+        {
+            REQUIRE(exp_paths.find(*path) != exp_paths.end());
+            seen.insert(*path);
+        }
+
+        REQUIRE(seen.size() == exp_paths.size());
+    }
+
+    SECTION("Bounded queue")
+    {
+        rad::FileStream stream{mgr.root().string(), 1};
+
+        std::size_t count{0};
+        while (auto path = stream.next())
+        {
+            REQUIRE(exp_paths.find(*path) != exp_paths.end());
+            ++count;
+        }
+
+        REQUIRE(count == exp_paths.size());
+    }
+
+    SECTION("Early exit")
+    {
+        rad::FileStream stream{mgr.root().string()};
+        REQUIRE(stream.next());
+
+        // The scanner is blocked on the full queue when the stream is destroyed.
+        rad::FileStream bounded{mgr.root().string(), 1};
+        REQUIRE(bounded.next());
+    }
+
+    SECTION("Invalid arguments")
+    {
+        REQUIRE_THROWS(rad::FileStream{(mgr.root() / "missing").string()});
+        REQUIRE_THROWS(rad::FileStream{mgr.root().string(), 0});
+    }
+}
@@ -0,0 +1,156 @@
+#include "test_file_manager.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/format.h>
+#include <oneapi/tbb/parallel_for.h>
+#include <opencv2/core/hal/interface.h>
+#include <opencv2/core/mat.hpp>
+#include <opencv2/imgcodecs.hpp>
+#include <rad/image_cache.hpp>
+#include <rad/processing_util.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <string>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    rad::ImageCacheKey make_key(int index)
+    {
+        return {.path = fmt::format("img_{}.png", index), .flags = cv::IMREAD_COLOR};
+    }
+} // namespace
+
+TEST_CASE("[image_cache] - ImageCache", "[rad]")
+{
+    // Every image takes 100 bytes, so the budget holds three of them.
+    const cv::Mat img = cv::Mat::ones(10, 10, CV_8UC1);
+
+    SECTION("Keys")
+    {
+        const TestFileManager::Params params{.num_files = 1};
+        const TestFileManager mgr{params};
+        const auto path = mgr.root() / "test_img_0.jpg";
+
+        auto key = rad::ImageCache::get_key(path, cv::IMREAD_COLOR);
+        REQUIRE(key.has_value());
+        REQUIRE(key == rad::ImageCache::get_key(path, cv::IMREAD_COLOR));
+        REQUIRE(key != rad::ImageCache::get_key(path, cv::IMREAD_GRAYSCALE));
+
+        fs::last_write_time(path, key->mtime + std::chrono::seconds{10});
+        REQUIRE(key != rad::ImageCache::get_key(path, cv::IMREAD_COLOR));
+        REQUIRE_FALSE(rad::ImageCache::get_key(mgr.root() / "missing.jpg", 0));
+    }
+
+    SECTION("Find and insert")
+    {
+        rad::ImageCache cache{300, 1};
+        REQUIRE_FALSE(cache.find(make_key(0)));
+        cache.insert(make_key(0), img);
+
+        auto cached = cache.find(make_key(0));
+        REQUIRE(cached.has_value());
+        REQUIRE(cached->data == img.data);
+        REQUIRE(cache.num_hits() == 1);
+        REQUIRE(cache.num_misses() == 1);
+        REQUIRE(cache.num_entries() == 1);
+        REQUIRE(cache.size_bytes() == 100);
+
+        // Empty images and images over budget are never stored.
+        cache.insert(make_key(1), cv::Mat{});
+        cache.insert(make_key(2), cv::Mat::ones(20, 20, CV_8UC1));
+        REQUIRE(cache.num_entries() == 1);
+
+        cache.clear();
+        REQUIRE(cache.num_entries() == 0);
+        REQUIRE(cache.size_bytes() == 0);
+    }
+
+    SECTION("Eviction")
+    {
+        rad::ImageCache cache{300, 1};
+        for (int i{0}; i < 3; ++i)
+        {
+            cache.insert(make_key(i), img);
+        }
+
+        // The first image was used most recently, so the second one is evicted.
+        REQUIRE(cache.find(make_key(0)));
+        cache.insert(make_key(3), img);
+        REQUIRE(cache.num_entries() == 3);
+        REQUIRE(cache.size_bytes() == 300);
+        REQUIRE(cache.find(make_key(0)));
+        REQUIRE_FALSE(cache.find(make_key(1)));
+        REQUIRE(cache.find(make_key(2)));
+        REQUIRE(cache.find(make_key(3)));
+    }
+
+    SECTION("Sharing the budget between shards")
+    {
+        // The large image is well over a quarter of the budget, so it has to take
+        // space from the other shards.
+        rad::ImageCache cache{300, 4};
+        for (int i{0}; i < 3; ++i)
+        {
+            cache.insert(make_key(i), img);
+        }
+
+        REQUIRE(cache.size_bytes() == 300);
+        cache.insert(make_key(3), cv::Mat::ones(10, 25, CV_8UC1));
+        REQUIRE(cache.size_bytes() <= 300);
+        REQUIRE(cache.find(make_key(3)));
+    }
+
+    SECTION("Concurrent access")
+    {
+        rad::ImageCache cache{1000, 4};
+        std::atomic<int> num_mismatched{0};
+        oneapi::tbb::parallel_for(0, 1000, [&cache, &img, &num_mismatched](int i) {
+            const auto key = make_key(i % 20);
+            if (auto cached = cache.find(key))
+            {
+                if (cached->size() != img.size())
+                {
+                    ++num_mismatched;
+                }
+            }
+            else
+            {
+                cache.insert(key, img);
+            }
+        });
+
+        REQUIRE(num_mismatched == 0);
+        REQUIRE(cache.num_hits() + cache.num_misses() == 1000);
+        REQUIRE(cache.size_bytes() <= cache.max_bytes());
+    }
+}
+
+TEST_CASE("[image_cache] - load_image", "[rad]")
+{
+    const TestFileManager::Params params{.num_files = 1};
+    const TestFileManager mgr{params};
+    const auto path = (mgr.root() / "test_img_0.jpg").string();
+
+    rad::ImageCache cache{1 << 20};
+    auto [name, img] = rad::load_image(path, cv::IMREAD_COLOR, cache);
+    REQUIRE(name == "test_img_0");
+    REQUIRE(img.size() == params.size);
+    REQUIRE(cache.num_misses() == 1);
+
+    auto [cached_name, cached] = rad::load_image(path, cv::IMREAD_COLOR, cache);
+    REQUIRE(cached_name == "test_img_0");
+    REQUIRE(cached.data == img.data);
+    REQUIRE(cache.num_hits() == 1);
+
+    // Modifying the file invalidates the entry.
+    cv::imwrite(path, cv::Mat::zeros(params.size, params.type));
+    fs::last_write_time(path, fs::last_write_time(path) + std::chrono::seconds{10});
+    auto [reloaded_name, reloaded] = rad::load_image(path, cv::IMREAD_COLOR, cache);
+    REQUIRE(reloaded.data != img.data);
+    REQUIRE(cache.num_misses() == 2);
+}
@@ -0,0 +1,168 @@
+#include "test_file_manager.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/format.h>
+#include <opencv2/core/hal/interface.h>
+#include <opencv2/core/mat.hpp>
+#include <opencv2/core/types.hpp>
+#include <rad/image_shard.hpp>
+#include <rad/processing_util.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace
+{
+    bool is_equal(cv::Mat const& lhs, cv::Mat const& rhs)
+    {
+        if (lhs.size() != rhs.size() || lhs.type() != rhs.type())
+        {
+            return false;
+        }
+
+        const auto row_bytes = static_cast<std::size_t>(lhs.cols) * lhs.elemSize();
+        for (int row{0}; row < lhs.rows; ++row)
+        {
+            if (std::memcmp(lhs.ptr(row), rhs.ptr(row), row_bytes) != 0)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    cv::Mat make_image(int rows, int cols, int type)
+    {
+        cv::Mat img{rows, cols, type};
+        const auto num_bytes = static_cast<std::size_t>(rows) * cols * img.elemSize();
+        for (std::size_t i{0}; i < num_bytes; ++i)
+        {
+            img.data[i] = static_cast<std::uint8_t>(i % 251);
+        }
+
+        return img;
+    }
+} // namespace
+
+TEST_CASE("[image_shard] - ImageShardWriter and ImageShard", "[rad]")
+{
+    const TestFileManager::Params params{.num_files = 0};
+    const TestFileManager mgr{params};
+    const auto path = mgr.root() / "images.shard";
+
+    const std::vector<cv::Mat> images{make_image(16, 16, CV_8UC3),
+                                      make_image(7, 13, CV_16UC1),
+                                      make_image(5, 9, CV_32FC4),
+                                      make_image(40, 40, CV_8UC1)(cv::Rect{3, 5, 11, 7})};
+
+    SECTION("Round trip")
+    {
+        {
+            rad::ImageShardWriter writer{path};
+            for (std::size_t i{0}; i < images.size(); ++i)
+            {
+                writer.add(fmt::format("img_{}", i), images[i]);
+            }
+            REQUIRE(writer.size() == images.size());
+            writer.finish();
+        }
+
+        const rad::ImageShard shard{path};
+        REQUIRE(shard.size() == images.size());
+        for (std::size_t i{0}; i < images.size(); ++i)
+        {
+            auto const& record = shard.records()[i];
+            REQUIRE(record.name == fmt::format("img_{}", i));
+            REQUIRE(record.offset % rad::ImageShard::alignment == 0);
+            REQUIRE(is_equal(shard.image(i), images[i]));
+        }
+    }
+
+    SECTION("Writes stay private")
+    {
+        {
+            rad::ImageShardWriter writer{path};
+            writer.add("img", images[0]);
+            writer.finish();
+            REQUIRE_THROWS(writer.add("img", images[0]));
+        }
+
+        {
+            const rad::ImageShard shard{path};
+            cv::Mat img = shard.image(0);
+            img.data[0] = 255;
+            REQUIRE(shard.image(0).data[0] == 255);
+        }
+
+        const rad::ImageShard shard{path};
+        REQUIRE(is_equal(shard.image(0), images[0]));
+    }
+
+    SECTION("Unfinished shards")
+    {
+        {
+            rad::ImageShardWriter writer{path};
+            writer.add("img", images[0]);
+        }
+
+        REQUIRE_FALSE(std::filesystem::exists(path));
+    }
+
+    SECTION("Invalid shards")
+    {
+        {
+            rad::ImageShardWriter writer{path};
+            REQUIRE_THROWS(writer.add("empty", cv::Mat{}));
+            writer.add("img", images[0]);
+            writer.finish();
+        }
+
+        auto bytes = rad::read_file_bytes(path.string());
+        auto write = [&path](std::vector<std::uint8_t> const& data) {
+            std::ofstream stream{path, std::ios::binary | std::ios::trunc};
+            stream.write(reinterpret_cast<char const*>(data.data()), // NOLINT
+                         static_cast<std::streamsize>(data.size()));
+        };
+
+        write({bytes.begin(), bytes.begin() + 100});
+        REQUIRE_THROWS(rad::ImageShard{path});
+
+        // Corrupt fields, including ones that would wrap the bounds checks around. The
+        // single record starts at the end of the header and the index follows it.
+        auto with_value = [&bytes](std::size_t offset, std::uint64_t value, int size) {
+            auto data = bytes;
+            for (int i{0}; i < size; ++i)
+            {
+                data[offset + i] = static_cast<std::uint8_t>(value >> (i * 8));
+            }
+            return data;
+        };
+
+        const std::size_t index_offset =
+            rad::ImageShard::header_size + (images[0].total() * images[0].elemSize());
+        write(with_value(24, ~std::uint64_t{0} - 7, 8));
+        REQUIRE_THROWS(rad::ImageShard{path});
+        write(with_value(index_offset, rad::ImageShard::header_size + 1, 8));
+        REQUIRE_THROWS(rad::ImageShard{path});
+        write(with_value(index_offset, 0, 8));
+        REQUIRE_THROWS(rad::ImageShard{path});
+        write(with_value(index_offset + 8, 0x7FFFFFFF, 4));
+        REQUIRE_THROWS(rad::ImageShard{path});
+        write(with_value(index_offset + 16, 0xFFFFFFFF, 4));
+        REQUIRE_THROWS(rad::ImageShard{path});
+        write(with_value(index_offset + 24, ~std::uint64_t{0}, 8));
+        REQUIRE_THROWS(rad::ImageShard{path});
+
+        write(bytes);
+        REQUIRE_NOTHROW(rad::ImageShard{path});
+
+        bytes[0] = 'X';
+        write(bytes);
+        REQUIRE_THROWS(rad::ImageShard{path});
+    }
+}
@@ -0,0 +1,62 @@
+#include "test_file_manager.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <rad/mapped_file.hpp>
+#include <rad/processing_util.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <utility>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+TEST_CASE("[mapped_file] - MappedFile", "[rad]")
+{
+    const TestFileManager mgr{TestFileManager::Params{.num_files = 1}};
+    const fs::path p = mgr.root() / "test_img_0.jpg";
+
+    SECTION("Map file")
+    {
+        const rad::MappedFile file{p};
+        const auto bytes = rad::read_file_bytes(p.string());
+        REQUIRE(file.size() == bytes.size());
+        REQUIRE(std::vector(file.data(), file.data() + file.size()) == bytes);
+    }
+
+    SECTION("Unmap")
+    {
+        rad::MappedFile file{p};
+        REQUIRE_FALSE(file.empty());
+
+        file.unmap();
+        REQUIRE(file.empty());
+        REQUIRE(file.data() == nullptr);
+    }
+
+    SECTION("Move")
+    {
+        rad::MappedFile file{p};
+        const auto size = file.size();
+
+        rad::MappedFile other{std::move(file)};
+        REQUIRE(other.size() == size);
+        REQUIRE(file.empty()); // NOLINT(bugprone-use-after-move)
+
+        file = std::move(other);
+        REQUIRE(file.size() == size);
+    }
+
+    SECTION("Empty file")
+    {
+        const fs::path empty = mgr.root() / "empty.jpg";
+        std::ofstream{empty};
+        const rad::MappedFile file{empty};
+        REQUIRE(file.empty());
+    }
+
+    SECTION("Missing file")
+    {
+        REQUIRE_THROWS(rad::MappedFile{mgr.root() / "missing.jpg"});
+    }
+}
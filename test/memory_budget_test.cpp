@@ -0,0 +1,75 @@
+#include <catch2/catch_test_macros.hpp>
+#include <oneapi/tbb/parallel_for.h>
+#include <rad/memory_budget.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+TEST_CASE("[memory_budget] - MemoryBudget", "[rad]")
+{
+    static constexpr std::size_t max_bytes{100};
+
+    SECTION("Reserve and release")
+    {
+        rad::MemoryBudget budget{max_bytes};
+        REQUIRE(budget.max_bytes() == max_bytes);
+
+        {
+            auto a = budget.reserve(40);
+            auto b = budget.reserve(60);
+            REQUIRE(a.size() == 40);
+            REQUIRE(budget.bytes_in_flight() == 100);
+
+            b.release();
+            REQUIRE(b.size() == 0);
+            REQUIRE(budget.bytes_in_flight() == 40);
+        }
+
+        REQUIRE(budget.bytes_in_flight() == 0);
+        REQUIRE(budget.peak_bytes_in_flight() == 100);
+    }
+
+    SECTION("Move")
+    {
+        rad::MemoryBudget budget{max_bytes};
+        rad::MemoryBudget::Reservation r;
+        {
+            auto a = budget.reserve(10);
+            r      = std::move(a);
+        }
+
+        REQUIRE(budget.bytes_in_flight() == 10);
+        r = {};
+        REQUIRE(budget.bytes_in_flight() == 0);
+    }
+
+    SECTION("Oversized request")
+    {
+        rad::MemoryBudget budget{max_bytes};
+        auto r = budget.reserve(max_bytes * 2);
+        REQUIRE(budget.bytes_in_flight() == max_bytes * 2);
+    }
+
+    SECTION("Concurrent reservations")
+    {
+        rad::MemoryBudget budget{max_bytes};
+        std::atomic<bool> exceeded{false};
+        oneapi::tbb::parallel_for(0, 200, [&](int) {
+            auto r = budget.reserve(30);
+            if (budget.bytes_in_flight() > max_bytes)
+            {
+                exceeded = true;
+            }
+        });
+
+        REQUIRE_FALSE(exceeded);
+        REQUIRE(budget.peak_bytes_in_flight() <= max_bytes);
+        REQUIRE(budget.bytes_in_flight() == 0);
+    }
+
+    SECTION("Invalid budget")
+    {
+        REQUIRE_THROWS(rad::MemoryBudget{0});
+    }
+}
@@ -0,0 +1,111 @@
+#include "test_file_manager.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <rad/prefetch_reader.hpp>
+#include <rad/processing_util.hpp>
+
+#include <cstddef>
+#include <filesystem>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+TEST_CASE("[prefetch_reader] - PrefetchReader", "[rad]")
+{
+    const TestFileManager::Params params;
+    const TestFileManager mgr{params};
+    const auto files = rad::get_file_paths_from_root(mgr.root().string());
+
+    auto check_reader = [&files](rad::PrefetchReader& reader) {
+        std::size_t count{0};
+        while (auto buffer = reader.next())
+        {
+            REQUIRE(count < files.size());
+            REQUIRE(buffer->path == files[count]);
+            REQUIRE(buffer->bytes == rad::read_file_bytes(files[count].string()));
+            ++count;
+        }
+
+        REQUIRE(count == files.size());
+        REQUIRE_FALSE(reader.next());
+    };
+
+    SECTION("Automatic backend")
+    {
+        rad::PrefetchReader reader{files, 4};
+        if (rad::PrefetchReader::is_io_uring_available())
+        {
+            REQUIRE(reader.backend() == rad::ReaderBackend::io_uring);
+        }
+        else
+        {
+            REQUIRE(reader.backend() == rad::ReaderBackend::thread_pool);
+        }
+
+        check_reader(reader);
+    }
+
+    SECTION("Thread pool backend")
+    {
+        rad::PrefetchReader reader{files, 3, rad::ReaderBackend::thread_pool};
+        REQUIRE(reader.backend() == rad::ReaderBackend::thread_pool);
+        check_reader(reader);
+    }
+
+    SECTION("io_uring backend")
+    {
+        if (rad::PrefetchReader::is_io_uring_available())
+        {
+            rad::PrefetchReader reader{files, 3, rad::ReaderBackend::io_uring};
+            REQUIRE(reader.backend() == rad::ReaderBackend::io_uring);
+            check_reader(reader);
+        }
+        else
+        {
+            REQUIRE_THROWS(
+                rad::PrefetchReader{files, 3, rad::ReaderBackend::io_uring});
+        }
+    }
+
+    SECTION("Window of one")
+    {
+        rad::PrefetchReader reader{files, 1};
+        check_reader(reader);
+    }
+
+    SECTION("Missing file")
+    {
+        const std::vector<fs::path> paths{files.front(),
+                                          mgr.root() / "missing.jpg",
+                                          files.back()};
+        std::vector<rad::ReaderBackend> backends{rad::ReaderBackend::thread_pool};
+        if (rad::PrefetchReader::is_io_uring_available())
+        {
+            backends.push_back(rad::ReaderBackend::io_uring);
+        }
+
+        for (auto backend : backends)
+        {
+            rad::PrefetchReader reader{paths, 2, backend};
+            REQUIRE_FALSE(reader.next()->bytes.empty());
+
+            const auto missing = reader.next();
+            REQUIRE(missing->path == paths[1]);
+            REQUIRE(missing->bytes.empty());
+
+            REQUIRE(reader.next()->bytes == rad::read_file_bytes(files.back().string()));
+            REQUIRE_FALSE(reader.next());
+        }
+    }
+
+    SECTION("Early destruction")
+    {
+        rad::PrefetchReader reader{files, 2};
+        REQUIRE(reader.next());
+    }
+
+    SECTION("Invalid window")
+    {
+        REQUIRE_THROWS(rad::PrefetchReader{files, 0});
+    }
+}
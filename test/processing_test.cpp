@@ -1,20 +1,51 @@
+#include "tar_writer.hpp"
 #include "test_file_manager.hpp"
 
 #include <catch2/catch_test_macros.hpp>
+#include <fmt/format.h>
+#include <oneapi/tbb/task_arena.h>
 #include <opencv2/core/hal/interface.h>
 #include <opencv2/core/mat.hpp>
 #include <opencv2/imgcodecs.hpp>
+#include <opencv2/videoio.hpp>
 #include <rad/processing.hpp>
 #include <zeus/platform.hpp> // NOLINT(misc-include-cleaner)
 #include <zeus/string.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <stdexcept>
 #include <string>
+#include <thread>
 #include <vector>
 
-#include <atomic>
-
 namespace fs = std::filesystem;
 
+namespace
+{
+    std::string create_video(fs::path const& path, int num_frames)
+    {
+        const cv::Size size{32, 32};
+        cv::VideoWriter writer{path.string(),
+                               cv::VideoWriter::fourcc('M', 'J', 'P', 'G'),
+                               10.0,
+                               size};
+        for (int i{0}; i < num_frames; ++i)
+        {
+            writer.write(cv::Mat{size, CV_8UC3, cv::Scalar::all(i)});
+        }
+
+        writer.release();
+        return path.string();
+    }
+} // namespace
+
 TEST_CASE("processing - process_images", "[rad]")
 {
     SECTION("Check files")
@@ -109,59 +140,1445 @@ TEST_CASE("processing - process_images", "[rad]")
     }
 }
 
-TEST_CASE("processing - process_files", "[rad]")
+TEST_CASE("processing - process_images with filter", "[rad]")
 {
     const TestFileManager::Params params;
     const TestFileManager mgr{params};
+    std::ofstream{mgr.root() / "meta.json"} << "{}";
+    std::ofstream{mgr.root() / ".DS_Store"} << "store";
+    std::ofstream{mgr.root() / "fake.jpg"} << "not an image";
 
     std::vector<std::atomic<bool>> seen_files(params.num_files);
+    std::atomic<int> num_calls{0};
 
-    auto fun = [&seen_files](std::string const& path) {
-        const fs::path p{path};
-        const std::string name = p.stem().string();
-
-        auto num           = zeus::split(name, '_')[2];
-        auto as_int        = std::stoi(num);
-        seen_files[as_int] = true;
+    auto fun = [&](std::string const& name, cv::Mat const& img) {
+        REQUIRE_FALSE(img.empty());
+        auto num                   = zeus::split(name, '_')[2];
+        seen_files[std::stoi(num)] = true;
+        ++num_calls;
     };
 
-    SECTION("Full list")
+    SECTION("Serial")
     {
-        rad::process_files(mgr.root().string(), fun);
-        for (auto const& seen : seen_files)
+        rad::process_images(mgr.root().string(),
+                            fun,
+                            cv::IMREAD_COLOR,
+                            rad::ImageFilter{});
+    }
+
+    SECTION("Parallel")
+    {
+        rad::process_images_parallel(mgr.root().string(),
+                                     fun,
+                                     cv::IMREAD_COLOR,
+                                     rad::ImageFilter{});
+    }
+
+    REQUIRE(num_calls == params.num_files);
+    for (auto const& seen : seen_files)
+    {
+        REQUIRE(seen);
+    }
+}
+
+TEST_CASE("processing - process_images with read mode", "[rad]")
+{
+    const TestFileManager::Params params;
+    const TestFileManager mgr{params};
+
+    std::vector<std::atomic<bool>> seen_files(params.num_files);
+    auto fun = [&](std::string const& name, cv::Mat const& img) {
+        REQUIRE(img.size() == params.size);
+        REQUIRE(img.type() == params.type);
+        auto num                   = zeus::split(name, '_')[2];
+        seen_files[std::stoi(num)] = true;
+    };
+
+    auto check_seen = [&seen_files] {
+        for (auto& seen : seen_files)
         {
             REQUIRE(seen);
+            seen = false;
         }
+    };
+
+    SECTION("imread")
+    {
+        const auto mode = rad::ImageReadMode::imread;
+        rad::process_images(mgr.root().string(), fun, cv::IMREAD_COLOR, mode);
+        check_seen();
+        rad::process_images_parallel(mgr.root().string(), fun, cv::IMREAD_COLOR, mode);
+        check_seen();
     }
 
-    SECTION("Full list - parallel")
+    SECTION("Mapped")
     {
-        rad::process_files_parallel(mgr.root().string(), fun);
-        for (auto const& seen : seen_files)
+        const auto mode = rad::ImageReadMode::mapped;
+        rad::process_images(mgr.root().string(), fun, cv::IMREAD_COLOR, mode);
+        check_seen();
+        rad::process_images_parallel(mgr.root().string(), fun, cv::IMREAD_COLOR, mode);
+        check_seen();
+    }
+
+#if defined(ZEUS_PLATFORM_LINUX)
+    SECTION("Unreadable files")
+    {
+        // A dangling link can be listed but not read, and both modes hand it to the
+        // function as an empty image.
+        fs::create_symlink(mgr.root() / "missing.jpg", mgr.root() / "broken.jpg");
+
+        std::atomic<int> num_empty{0};
+        auto count_empty = [&num_empty](std::string const&, cv::Mat const& img) {
+            if (img.empty())
+            {
+                ++num_empty;
+            }
+        };
+
+        for (auto mode : {rad::ImageReadMode::imread, rad::ImageReadMode::mapped})
         {
-            REQUIRE(seen);
+            REQUIRE_NOTHROW(rad::process_images(mgr.root().string(),
+                                                count_empty,
+                                                cv::IMREAD_COLOR,
+                                                mode));
+            REQUIRE_NOTHROW(rad::process_images_parallel(mgr.root().string(),
+                                                         count_empty,
+                                                         cv::IMREAD_COLOR,
+                                                         mode));
         }
+
+        REQUIRE(num_empty == 4);
     }
+#endif
+}
 
-    SECTION("Partial list")
+TEST_CASE("processing - parallel processing in an arena", "[rad]")
+{
+    const TestFileManager::Params params;
+    const TestFileManager mgr{params};
+    static constexpr int max_concurrency{2};
+
+    std::atomic<int> num_calls{0};
+    std::atomic<bool> within_limit{true};
+    auto check_limit = [&] {
+        ++num_calls;
+        if (oneapi::tbb::this_task_arena::max_concurrency() != max_concurrency)
+        {
+            within_limit = false;
+        }
+    };
+
+    SECTION("task_arena")
     {
-        const std::vector<std::string> samples{"test_img_0.jpg",
-                                               "test_img_2.jpg",
-                                               "test_img_4.jpg"};
-        rad::process_files(mgr.root().string(), fun);
-        REQUIRE(seen_files[0]);
-        REQUIRE(seen_files[2]);
-        REQUIRE(seen_files[4]);
+        oneapi::tbb::task_arena arena{max_concurrency};
+        rad::process_images_parallel(
+            mgr.root().string(),
+            [&](std::string const&, cv::Mat const&) {
+                check_limit();
+            },
+            cv::IMREAD_COLOR,
+            arena);
+        rad::process_files_parallel(
+            mgr.root().string(),
+            [&](std::string const&) {
+                check_limit();
+            },
+            arena);
     }
 
-    SECTION("Partial list - parallel")
+    SECTION("WorkerArena")
     {
-        const std::vector<std::string> samples{"test_img_0.jpg",
-                                               "test_img_2.jpg",
-                                               "test_img_4.jpg"};
-        rad::process_files_parallel(mgr.root().string(), fun);
-        REQUIRE(seen_files[0]);
-        REQUIRE(seen_files[2]);
-        REQUIRE(seen_files[4]);
+        rad::WorkerArena arena{max_concurrency};
+        rad::process_images_parallel(
+            mgr.root().string(),
+            [&](std::string const&, cv::Mat const&) {
+                check_limit();
+            },
+            cv::IMREAD_COLOR,
+            arena);
+        rad::process_files_parallel(
+            mgr.root().string(),
+            [&](std::string const&) {
+                check_limit();
+            },
+            arena);
+    }
+
+    REQUIRE(num_calls == params.num_files * 2);
+    REQUIRE(within_limit);
+}
+
+TEST_CASE("processing - per-worker state", "[rad]")
+{
+    const TestFileManager::Params params;
+    const TestFileManager mgr{params};
+
+    struct WorkerState
+    {
+        int num_images{0};
+        cv::Mat scratch;
+    };
+
+    std::atomic<int> num_states{0};
+    auto factory = [&num_states] {
+        ++num_states;
+        return WorkerState{};
+    };
+
+    auto fun = [&params](WorkerState& state, std::string const&, cv::Mat const& img) {
+        REQUIRE(img.type() == params.type);
+        img.copyTo(state.scratch);
+        ++state.num_images;
+    };
+
+    auto combine = [](WorkerState const& a, WorkerState const& b) {
+        return WorkerState{.num_images = a.num_images + b.num_images, .scratch = {}};
+    };
+
+    SECTION("Without combine")
+    {
+        rad::process_images_parallel(mgr.root().string(), factory, fun);
+        REQUIRE(num_states >= 1);
+        REQUIRE(num_states <= params.num_files);
+    }
+
+    SECTION("With combine")
+    {
+        auto result =
+            rad::process_images_parallel(mgr.root().string(), factory, fun, combine);
+        REQUIRE(result.num_images == params.num_files);
+    }
+
+    SECTION("Files")
+    {
+        auto total = rad::process_files_parallel(
+            mgr.root().string(),
+            [] {
+                return std::uintmax_t{0};
+            },
+            [](std::uintmax_t& size, std::string const& path) {
+                size += fs::file_size(path);
+            },
+            [](std::uintmax_t a, std::uintmax_t b) {
+                return a + b;
+            });
+
+        std::uintmax_t exp_total{0};
+        for (auto const& path : rad::get_file_paths_from_root(mgr.root().string()))
+        {
+            exp_total += fs::file_size(path);
+        }
+
+        REQUIRE(total == exp_total);
+    }
+}
+
+TEST_CASE("processing - fault-tolerant parallel processing", "[rad]")
+{
+    const TestFileManager::Params params{.num_files = 20};
+    const TestFileManager mgr{params};
+
+    // Every third file fails, once with an OpenCV error and once with a standard one.
+    auto get_index = [](std::string const& name) {
+        return std::stoi(zeus::split(fs::path{name}.stem().string(), '_')[2]);
+    };
+    auto maybe_throw = [](int index) {
+        if (index % 3 != 0)
+        {
+            return;
+        }
+
+        if (index % 2 == 0)
+        {
+            throw cv::Exception{};
+        }
+
+        throw std::runtime_error{"error: bad file"};
+    };
+
+    std::vector<std::atomic<int>> counts(params.num_files);
+    auto check_failures = [&](std::vector<rad::ProcessingFailure> const& failures) {
+        REQUIRE(failures.size() == 7);
+        REQUIRE(std::ranges::is_sorted(failures, {}, &rad::ProcessingFailure::path));
+        for (auto const& failure : failures)
+        {
+            REQUIRE(get_index(failure.path) % 3 == 0);
+        }
+
+        for (int i{0}; i < params.num_files; ++i)
+        {
+            REQUIRE(counts[i] == (i % 3 == 0 ? 0 : 1));
+            counts[i] = 0;
+        }
+    };
+
+    SECTION("Images")
+    {
+        auto failures = rad::process_images_parallel_safe(
+            mgr.root().string(),
+            [&](std::string const& name, cv::Mat const&) {
+                const auto index = get_index(name);
+                maybe_throw(index);
+                ++counts[index];
+            });
+        check_failures(failures);
+    }
+
+    SECTION("Files")
+    {
+        auto failures = rad::process_files_parallel_safe(
+            mgr.root().string(),
+            [&](std::string const& path) {
+                const auto index = get_index(path);
+                maybe_throw(index);
+                ++counts[index];
+            });
+        check_failures(failures);
+    }
+}
+
+TEST_CASE("processing - parallel reduction", "[rad]")
+{
+    const TestFileManager::Params params{.num_files = 20};
+    const TestFileManager mgr{params};
+
+    auto add = [](std::size_t a, std::size_t b) {
+        return a + b;
+    };
+
+    SECTION("Images")
+    {
+        const auto num_pixels = rad::process_images_reduce(
+            mgr.root().string(),
+            std::size_t{0},
+            [](std::string const&, cv::Mat const& img) {
+                return static_cast<std::size_t>(img.total());
+            },
+            add);
+        REQUIRE(num_pixels
+                == static_cast<std::size_t>(params.num_files) * params.size.area());
+    }
+
+    SECTION("Images with non-trivial state")
+    {
+        // Histogram of the file indices, combined element-wise.
+        using Histogram = std::vector<int>;
+        const auto histogram = rad::process_images_reduce(
+            mgr.root().string(),
+            Histogram(params.num_files, 0),
+            [&params](std::string const& name, cv::Mat const&) {
+                Histogram result(params.num_files, 0);
+                ++result[std::stoi(zeus::split(name, '_')[2])];
+                return result;
+            },
+            [](Histogram a, Histogram const& b) {
+                std::ranges::transform(a, b, a.begin(), std::plus<>{});
+                return a;
+            },
+            cv::IMREAD_GRAYSCALE);
+        REQUIRE(std::ranges::all_of(histogram, [](int count) {
+            return count == 1;
+        }));
+    }
+
+    SECTION("Files")
+    {
+        const auto num_files = rad::process_files_reduce(
+            mgr.root().string(),
+            std::size_t{0},
+            [](std::string const&) {
+                return std::size_t{1};
+            },
+            add);
+        REQUIRE(num_files == static_cast<std::size_t>(params.num_files));
+    }
+}
+
+TEST_CASE("processing - process_raster_tiled", "[rad]")
+{
+    const TestFileManager::Params params{.num_files = 0};
+    const TestFileManager mgr{params};
+    const cv::Size size{90, 60};
+    const cv::Size tile_size{32, 32};
+    static constexpr int overlap{2};
+
+    const auto input = (mgr.root() / "input.raw").string();
+    {
+        std::vector<char> bytes(static_cast<std::size_t>(size.area()));
+        for (std::size_t i{0}; i < bytes.size(); ++i)
+        {
+            bytes[i] = static_cast<char>(i % 128);
+        }
+        std::ofstream stream{input, std::ios::binary};
+        stream.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+    const rad::RasterLayout layout{.size = size, .type = CV_8UC1};
+
+    SECTION("Read only")
+    {
+        std::atomic<int> num_pixels{0};
+        rad::process_raster_tiled(
+            input,
+            layout,
+            tile_size,
+            overlap,
+            [&num_pixels](rad::TileSpec const& tile, cv::Mat const& img) {
+                REQUIRE(img.size() == tile.roi.size());
+                num_pixels += tile.core.area();
+            });
+        REQUIRE(num_pixels == size.area());
+    }
+
+    SECTION("With output")
+    {
+        const auto output = (mgr.root() / "output.raw").string();
+        rad::process_raster_tiled(input,
+                                  layout,
+                                  tile_size,
+                                  overlap,
+                                  output,
+                                  CV_8UC1,
+                                  [](rad::TileSpec const&, cv::Mat const& img) {
+                                      cv::Mat result;
+                                      img.convertTo(result, CV_8U, 2.0);
+                                      return result;
+                                  });
+
+        const auto in_bytes  = rad::read_file_bytes(input);
+        const auto out_bytes = rad::read_file_bytes(output);
+        REQUIRE(out_bytes.size() == in_bytes.size());
+        for (std::size_t i{0}; i < in_bytes.size(); ++i)
+        {
+            REQUIRE(out_bytes[i] == in_bytes[i] * 2);
+        }
+    }
+}
+
+TEST_CASE("processing - process_images with result cache", "[rad]")
+{
+    // Results are keyed by content, so every input needs to be different.
+    const TestFileManager::Params params{.ext = "png"};
+    const TestFileManager mgr{{.num_files = 0}};
+    for (int i{0}; i < params.num_files; ++i)
+    {
+        const cv::Mat img{params.size, params.type, cv::Scalar::all(i)};
+        const auto name = fmt::format("{}_{}.{}", params.prefix, i, params.ext);
+        cv::imwrite((mgr.root() / name).string(), img);
+    }
+
+    const auto result_root = (mgr.root() / "results").string();
+    const auto cache_root  = mgr.root() / "cache";
+    const std::string app_name{"cached"};
+
+    std::atomic<int> num_calls{0};
+    auto fun = [&num_calls](std::string const&, cv::Mat const& img) {
+        ++num_calls;
+        return img;
+    };
+
+    auto check_results = [&] {
+        for (int i{0}; i < params.num_files; ++i)
+        {
+            const auto name = fmt::format("{}_{}.{}", params.prefix, i, params.ext);
+            REQUIRE(fs::exists(fs::path{result_root} / app_name / name));
+        }
+    };
+
+    SECTION("Sequential")
+    {
+        rad::ResultCache cache{cache_root, "v1"};
+        rad::process_images(mgr.root().string(), cache, result_root, app_name, fun);
+        REQUIRE(num_calls == params.num_files);
+        REQUIRE(cache.num_stores() == static_cast<std::size_t>(params.num_files));
+        check_results();
+
+        // Nothing changed, so every result comes from the cache.
+        fs::remove_all(fs::path{result_root} / app_name);
+        rad::process_images(mgr.root().string(), cache, result_root, app_name, fun);
+        REQUIRE(num_calls == params.num_files);
+        REQUIRE(cache.num_hits() == static_cast<std::size_t>(params.num_files));
+        check_results();
+
+        // A new version invalidates every entry.
+        rad::ResultCache new_cache{cache_root, "v2"};
+        rad::process_images(mgr.root().string(), new_cache, result_root, app_name, fun);
+        REQUIRE(num_calls == params.num_files * 2);
+        REQUIRE(new_cache.num_hits() == 0);
+        check_results();
+
+        // Results decoded with other flags or made by another app aren't reused.
+        rad::process_images(mgr.root().string(),
+                            new_cache,
+                            result_root,
+                            app_name,
+                            fun,
+                            cv::IMREAD_GRAYSCALE);
+        rad::process_images(mgr.root().string(), new_cache, result_root, "other", fun);
+        REQUIRE(num_calls == params.num_files * 4);
+        REQUIRE(new_cache.num_hits() == 0);
+    }
+
+    SECTION("Parallel")
+    {
+        rad::ResultCache cache{cache_root, "v1"};
+        rad::process_images_parallel(mgr.root().string(),
+                                     cache,
+                                     result_root,
+                                     app_name,
+                                     fun);
+        REQUIRE(num_calls == params.num_files);
+        check_results();
+
+        // Changing one input only reprocesses that file.
+        const cv::Mat img{params.size, params.type, cv::Scalar::all(255)};
+        cv::imwrite((mgr.root() / fmt::format("{}_0.png", params.prefix)).string(), img);
+        rad::process_images_parallel(mgr.root().string(),
+                                     cache,
+                                     result_root,
+                                     app_name,
+                                     fun);
+        REQUIRE(num_calls == params.num_files + 1);
+        REQUIRE(cache.num_hits() == static_cast<std::size_t>(params.num_files - 1));
+        check_results();
+    }
+
+    SECTION("Empty results")
+    {
+        rad::ResultCache cache{cache_root, "v1"};
+        rad::process_images(mgr.root().string(), cache, result_root, app_name, fun);
+
+        // The results of the previous run are still in place, but none of them were
+        // produced under the new version.
+        rad::ResultCache new_cache{cache_root, "v2"};
+        auto empty_fun = [](std::string const&, cv::Mat const&) {
+            return cv::Mat{};
+        };
+        rad::process_images(mgr.root().string(),
+                            new_cache,
+                            result_root,
+                            app_name,
+                            empty_fun);
+        REQUIRE(new_cache.num_stores() == 0);
+
+        rad::process_images(mgr.root().string(), new_cache, result_root, app_name, fun);
+        REQUIRE(num_calls == params.num_files * 2);
+        REQUIRE(new_cache.num_hits() == 0);
+    }
+
+#if defined(ZEUS_PLATFORM_LINUX)
+    SECTION("Unreadable files")
+    {
+        // A dangling link can be listed but not read.
+        fs::create_symlink(mgr.root() / "missing.png", mgr.root() / "broken.png");
+
+        std::atomic<int> num_empty{0};
+        auto count_fun = [&](std::string const& name, cv::Mat const& img) {
+            if (img.empty())
+            {
+                ++num_empty;
+            }
+
+            return fun(name, img);
+        };
+
+        rad::ResultCache cache{cache_root, "v1"};
+        REQUIRE_NOTHROW(rad::process_images_parallel(mgr.root().string(),
+                                                     cache,
+                                                     result_root,
+                                                     app_name,
+                                                     count_fun));
+        REQUIRE(num_empty == 1);
+        REQUIRE(cache.num_stores() == static_cast<std::size_t>(params.num_files));
+        check_results();
+    }
+#endif
+}
+
+TEST_CASE("processing - process_images from a tar archive", "[rad]")
+{
+    const TestFileManager::Params params;
+    const TestFileManager mgr{params};
+
+    TarWriter writer;
+    writer.add_directory("images/");
+    for (auto const& entry : rad::get_file_paths_from_root(mgr.root().string()))
+    {
+        writer.add_file("images/" + entry.filename().string(),
+                        rad::read_file_bytes(entry.string()));
+    }
+
+    const auto path = mgr.root() / "images.tar";
+    writer.write(path);
+    const rad::TarArchive archive{path};
+
+    std::vector<std::atomic<int>> counts(params.num_files);
+    auto fun = [&counts, &params](std::string const& name, cv::Mat const& img) {
+        REQUIRE(img.size() == params.size);
+        ++counts[std::stoi(zeus::split(name, '_')[2])];
+    };
+
+    SECTION("Sequential")
+    {
+        rad::process_images(archive, fun);
+    }
+
+    SECTION("Parallel")
+    {
+        rad::process_images_parallel(archive, fun, cv::IMREAD_COLOR);
+    }
+
+    for (auto const& count : counts)
+    {
+        REQUIRE(count == 1);
     }
 }
+
+TEST_CASE("processing - process_images from an image shard", "[rad]")
+{
+    const TestFileManager::Params params;
+    const TestFileManager mgr{params};
+    const auto path = mgr.root().parent_path() / "images.shard";
+
+    // Files that aren't images are left out of the shard.
+    std::ofstream{mgr.root() / "README.txt"} << "not an image";
+    rad::write_image_shard(mgr.root().string(), path);
+    const rad::ImageShard shard{path};
+    REQUIRE(shard.size() == static_cast<std::size_t>(params.num_files));
+
+    std::vector<std::atomic<int>> counts(params.num_files);
+    auto fun = [&counts, &params](std::string const& name, cv::Mat const& img) {
+        REQUIRE(img.size() == params.size);
+        REQUIRE(img.type() == params.type);
+        ++counts[std::stoi(zeus::split(name, '_')[2])];
+    };
+
+    SECTION("Sequential")
+    {
+        rad::process_images(shard, fun);
+    }
+
+    SECTION("Parallel")
+    {
+        rad::process_images_parallel(shard, fun);
+    }
+
+    for (auto const& count : counts)
+    {
+        REQUIRE(count == 1);
+    }
+
+    fs::remove(path);
+}
+
+TEST_CASE("processing - process_images with an image cache", "[rad]")
+{
+    const TestFileManager::Params params;
+    const TestFileManager mgr{params};
+    rad::ImageCache cache{std::size_t{1} << 24};
+
+    std::atomic<int> count{0};
+    auto fun = [&count, &params](std::string const&, cv::Mat const& img) {
+        REQUIRE(img.size() == params.size);
+        ++count;
+    };
+
+    SECTION("Sequential")
+    {
+        rad::process_images(mgr.root().string(), fun, cv::IMREAD_COLOR, cache);
+        rad::process_images(mgr.root().string(), fun, cv::IMREAD_COLOR, cache);
+    }
+
+    SECTION("Parallel")
+    {
+        rad::process_images_parallel(mgr.root().string(), fun, cv::IMREAD_COLOR, cache);
+        rad::process_images_parallel(mgr.root().string(), fun, cv::IMREAD_COLOR, cache);
+    }
+
+    REQUIRE(count == 2 * params.num_files);
+    REQUIRE(cache.num_misses() == static_cast<std::size_t>(params.num_files));
+    REQUIRE(cache.num_hits() == static_cast<std::size_t>(params.num_files));
+}
+
+TEST_CASE("processing - sharded processing", "[rad]")
+{
+    const TestFileManager::Params params{.num_files = 20};
+    const TestFileManager mgr{params};
+    static constexpr std::size_t num_shards{3};
+
+    std::vector<std::atomic<int>> counts(params.num_files);
+    auto image_fun = [&counts](std::string const& name, cv::Mat const&) {
+        ++counts[std::stoi(zeus::split(name, '_')[2])];
+    };
+    auto file_fun = [&counts](std::string const& path) {
+        ++counts[std::stoi(zeus::split(fs::path{path}.stem().string(), '_')[2])];
+    };
+
+    for (std::size_t i{0}; i < num_shards; ++i)
+    {
+        const rad::ShardSpec shard{.index = i, .count = num_shards};
+        rad::process_images(mgr.root().string(), image_fun, cv::IMREAD_COLOR, shard);
+        rad::process_images_parallel(mgr.root().string(),
+                                     image_fun,
+                                     cv::IMREAD_COLOR,
+                                     shard);
+        rad::process_files_parallel(mgr.root().string(), file_fun, shard);
+    }
+
+    // Every file belongs to exactly one shard, so each function saw it once.
+    for (auto const& count : counts)
+    {
+        REQUIRE(count == 3);
+    }
+}
+
+TEST_CASE("processing - process_images_parallel with scheduling", "[rad]")
+{
+    const TestFileManager::Params params;
+    const TestFileManager mgr{params};
+
+    std::vector<std::atomic<bool>> seen_files(params.num_files);
+    auto fun = [&seen_files, params](std::string const& name, cv::Mat const& img) {
+        REQUIRE(img.type() == params.type);
+        auto num                   = zeus::split(name, '_')[2];
+        seen_files[std::stoi(num)] = true;
+    };
+
+    SECTION("Directory order")
+    {
+        rad::process_images_parallel(mgr.root().string(),
+                                     fun,
+                                     cv::IMREAD_COLOR,
+                                     rad::SchedulingPolicy::directory_order);
+    }
+
+    SECTION("Largest first")
+    {
+        rad::process_images_parallel(mgr.root().string(),
+                                     fun,
+                                     cv::IMREAD_COLOR,
+                                     rad::SchedulingPolicy::largest_first);
+    }
+
+    SECTION("Balanced")
+    {
+        rad::process_images_parallel(mgr.root().string(),
+                                     fun,
+                                     cv::IMREAD_COLOR,
+                                     rad::SchedulingPolicy::balanced);
+    }
+
+    for (auto const& seen : seen_files)
+    {
+        REQUIRE(seen);
+    }
+}
+
+TEST_CASE("processing - process_images with manifest", "[rad]")
+{
+    const TestFileManager::Params params;
+    const TestFileManager mgr{params};
+    const fs::path result_root = fs::absolute("./test_root");
+    const std::string app_name = "app";
+
+    std::vector<std::atomic<int>> num_calls(params.num_files);
+    auto fun = [&num_calls](std::string const& name, cv::Mat const& img) {
+        if (img.empty())
+        {
+            return;
+        }
+
+        auto num = zeus::split(name, '_')[2];
+        ++num_calls[std::stoi(num)];
+    };
+
+    {
+        // Simulate a previous run that only got through the first two files.
+        rad::CompletionManifest manifest{result_root.string(), app_name};
+        manifest.mark_complete("test_img_0.jpg");
+        manifest.mark_complete("test_img_1.jpg");
+    }
+
+    SECTION("Serial")
+    {
+        rad::CompletionManifest manifest{result_root.string(), app_name};
+        rad::process_images(mgr.root().string(), manifest, fun);
+        REQUIRE(manifest.num_completed() == static_cast<std::size_t>(params.num_files));
+    }
+
+    SECTION("Parallel")
+    {
+        rad::CompletionManifest manifest{result_root.string(), app_name};
+        rad::process_images_parallel(mgr.root().string(), manifest, fun);
+        REQUIRE(manifest.num_completed() == static_cast<std::size_t>(params.num_files));
+    }
+
+    SECTION("Files that fail to decode")
+    {
+        // They aren't marked complete, so a transient failure is retried next time.
+        std::ofstream{mgr.root() / "notes.txt"} << "not an image";
+        rad::CompletionManifest manifest{result_root.string(), app_name};
+        rad::process_images(mgr.root().string(), manifest, fun);
+        REQUIRE(manifest.num_completed() == static_cast<std::size_t>(params.num_files));
+        REQUIRE_FALSE(manifest.is_complete("notes.txt"));
+    }
+
+    REQUIRE(num_calls[0] == 0);
+    REQUIRE(num_calls[1] == 0);
+    for (int i{2}; i < params.num_files; ++i)
+    {
+        REQUIRE(num_calls[i] == 1);
+    }
+
+    // Running again should not process anything.
+    rad::CompletionManifest manifest{result_root.string(), app_name};
+    rad::process_images_parallel(mgr.root().string(), manifest, fun);
+    for (int i{2}; i < params.num_files; ++i)
+    {
+        REQUIRE(num_calls[i] == 1);
+    }
+
+    fs::remove_all(result_root);
+}
+
+TEST_CASE("processing - process_images_parallel with progress", "[rad]")
+{
+    const TestFileManager::Params params;
+    const TestFileManager mgr{params};
+
+    SECTION("Images")
+    {
+        std::size_t total_bytes{0};
+        for (auto const& path : rad::get_file_paths_from_root(mgr.root().string()))
+        {
+            total_bytes += fs::file_size(path);
+        }
+
+        std::atomic<int> num_calls{0};
+        rad::ProgressSnapshot last;
+        rad::ProgressContext progress{[&last](rad::ProgressSnapshot const& snapshot) {
+            last = snapshot;
+        }};
+
+        rad::process_images_parallel(mgr.root().string(),
+                                     progress,
+                                     [&](std::string const&, cv::Mat const& img) {
+                                         REQUIRE(img.type() == params.type);
+                                         ++num_calls;
+                                     });
+
+        REQUIRE(num_calls == params.num_files);
+        REQUIRE(last.total == static_cast<std::size_t>(params.num_files));
+        REQUIRE(last.processed == static_cast<std::size_t>(params.num_files));
+        REQUIRE(last.failed == 0);
+        REQUIRE(last.remaining == 0);
+        REQUIRE(last.bytes_read == total_bytes);
+    }
+
+    SECTION("Failed images")
+    {
+        std::ofstream{mgr.root() / "fake.jpg"} << "not an image";
+        rad::ProgressContext progress;
+        rad::process_images_parallel(mgr.root().string(),
+                                     progress,
+                                     [](std::string const&, cv::Mat const&) {});
+
+        auto snapshot = progress.snapshot();
+        REQUIRE(snapshot.processed == static_cast<std::size_t>(params.num_files));
+        REQUIRE(snapshot.failed == 1);
+    }
+
+    SECTION("Throwing functions")
+    {
+        // The interval is long enough that the only report is the final one.
+        int num_reports{0};
+        rad::ProgressSnapshot last;
+        rad::ProgressContext progress{[&](rad::ProgressSnapshot const& snapshot) {
+                                          ++num_reports;
+                                          last = snapshot;
+                                      },
+                                      std::chrono::hours{1}};
+
+        REQUIRE_THROWS(rad::process_images_parallel(
+            mgr.root().string(),
+            progress,
+            [](std::string const&, cv::Mat const&) {
+                throw std::runtime_error{"error: processing failed"};
+            }));
+        REQUIRE(num_reports == 1);
+        REQUIRE(last.failed > 0);
+    }
+
+    SECTION("Cancellation")
+    {
+        rad::ProgressContext progress;
+        progress.cancel();
+
+        std::atomic<int> num_calls{0};
+        rad::process_files_parallel(mgr.root().string(),
+                                    progress,
+                                    [&num_calls](std::string const&) {
+                                        ++num_calls;
+                                    });
+
+        auto snapshot = progress.snapshot();
+        REQUIRE(num_calls == 0);
+        REQUIRE(snapshot.processed == 0);
+        REQUIRE(snapshot.remaining == static_cast<std::size_t>(params.num_files));
+    }
+}
+
+TEST_CASE("processing - process_images_parallel with memory budget", "[rad]")
+{
+    const TestFileManager::Params params;
+    const TestFileManager mgr{params};
+
+    // Each 64x64 colour image decodes to 12KB, so at most two fit in the budget.
+    const std::size_t image_bytes = static_cast<std::size_t>(params.size.area()) * 3;
+    rad::MemoryBudget budget{image_bytes * 2};
+
+    std::vector<std::atomic<bool>> seen_files(params.num_files);
+    auto fun = [&](std::string const& name, cv::Mat const& img) {
+        REQUIRE(img.type() == params.type);
+        REQUIRE(budget.bytes_in_flight() <= budget.max_bytes());
+        auto num                   = zeus::split(name, '_')[2];
+        seen_files[std::stoi(num)] = true;
+    };
+
+    rad::process_images_parallel(mgr.root().string(), fun, cv::IMREAD_COLOR, budget);
+    for (auto const& seen : seen_files)
+    {
+        REQUIRE(seen);
+    }
+
+    REQUIRE(budget.peak_bytes_in_flight() <= budget.max_bytes());
+    REQUIRE(budget.bytes_in_flight() == 0);
+}
+
+TEST_CASE("processing - process_files", "[rad]")
+{
+    const TestFileManager::Params params;
+    const TestFileManager mgr{params};
+
+    std::vector<std::atomic<bool>> seen_files(params.num_files);
+
+    auto fun = [&seen_files](std::string const& path) {
+        const fs::path p{path};
+        const std::string name = p.stem().string();
+
+        auto num           = zeus::split(name, '_')[2];
+        auto as_int        = std::stoi(num);
+        seen_files[as_int] = true;
+    };
+
+    SECTION("Full list")
+    {
+        rad::process_files(mgr.root().string(), fun);
+        for (auto const& seen : seen_files)
+        {
+            REQUIRE(seen);
+        }
+    }
+
+    SECTION("Full list - parallel")
+    {
+        rad::process_files_parallel(mgr.root().string(), fun);
+        for (auto const& seen : seen_files)
+        {
+            REQUIRE(seen);
+        }
+    }
+
+    SECTION("Partial list")
+    {
+        const std::vector<std::string> samples{"test_img_0.jpg",
+                                               "test_img_2.jpg",
+                                               "test_img_4.jpg"};
+        rad::process_files(mgr.root().string(), fun);
+        REQUIRE(seen_files[0]);
+        REQUIRE(seen_files[2]);
+        REQUIRE(seen_files[4]);
+    }
+
+    SECTION("Partial list - parallel")
+    {
+        const std::vector<std::string> samples{"test_img_0.jpg",
+                                               "test_img_2.jpg",
+                                               "test_img_4.jpg"};
+        rad::process_files_parallel(mgr.root().string(), fun);
+        REQUIRE(seen_files[0]);
+        REQUIRE(seen_files[2]);
+        REQUIRE(seen_files[4]);
+    }
+}
+
+TEST_CASE("processing - process_images_pipelined", "[rad]")
+{
+    const TestFileManager::Params params;
+    const TestFileManager mgr{params};
+    static constexpr std::size_t max_tokens{4};
+
+    std::vector<std::atomic<bool>> seen_files(params.num_files);
+
+    SECTION("Without sink")
+    {
+        std::atomic<int> in_flight{0};
+        std::atomic<int> max_in_flight{0};
+        auto fun = [&](std::string const& name, cv::Mat const& img) {
+            const int current = ++in_flight;
+            int prev          = max_in_flight.load();
+            while (prev < current && !max_in_flight.compare_exchange_weak(prev, current))
+            {}
+
+            REQUIRE(img.type() == params.type);
+            auto num                   = zeus::split(name, '_')[2];
+            seen_files[std::stoi(num)] = true;
+            --in_flight;
+        };
+
+        rad::process_images_pipelined(mgr.root().string(), fun, max_tokens);
+        for (auto const& seen : seen_files)
+        {
+            REQUIRE(seen);
+        }
+        REQUIRE(max_in_flight <= static_cast<int>(max_tokens));
+    }
+
+    SECTION("With sink")
+    {
+        auto fun = [](std::string const&, cv::Mat const& img) {
+            return img.rows;
+        };
+
+        std::vector<std::string> names;
+        auto sink = [&](std::string const& name, int rows) {
+            REQUIRE(rows == params.size.height);
+            names.push_back(name);
+        };
+
+        rad::process_images_pipelined(mgr.root().string(), fun, sink, max_tokens);
+        REQUIRE(names.size() == static_cast<std::size_t>(params.num_files));
+        for (auto const& name : names)
+        {
+            auto num                   = zeus::split(name, '_')[2];
+            seen_files[std::stoi(num)] = true;
+        }
+
+        for (auto const& seen : seen_files)
+        {
+            REQUIRE(seen);
+        }
+    }
+
+    SECTION("Unreadable files")
+    {
+        // With a single token the next file is only read once the current one has been
+        // processed, so removing the rest from here makes them disappear after the
+        // directory was listed.
+        int num_loaded{0};
+        int num_empty{0};
+        auto fun = [&](std::string const& name, cv::Mat const& img) {
+            if (img.empty())
+            {
+                ++num_empty;
+                return;
+            }
+
+            ++num_loaded;
+            std::vector<fs::path> others;
+            for (auto const& entry : fs::directory_iterator{mgr.root()})
+            {
+                if (entry.path().stem() != name)
+                {
+                    others.push_back(entry.path());
+                }
+            }
+
+            for (auto const& path : others)
+            {
+                fs::remove(path);
+            }
+        };
+
+        REQUIRE_NOTHROW(rad::process_images_pipelined(mgr.root().string(), fun, 1));
+        REQUIRE(num_loaded == 1);
+        REQUIRE(num_empty == params.num_files - 1);
+    }
+
+    SECTION("Invalid tokens")
+    {
+        auto fun = [](std::string const&, cv::Mat const&) {};
+        REQUIRE_THROWS(rad::process_images_pipelined(mgr.root().string(), fun, 0));
+    }
+}
+
+TEST_CASE("processing - ordered processing", "[rad]")
+{
+    const TestFileManager::Params params;
+    const TestFileManager mgr{params};
+    static constexpr std::size_t max_tokens{4};
+
+    std::vector<std::string> exp_paths;
+    for (auto const& path : rad::get_file_paths_from_root(mgr.root().string()))
+    {
+        exp_paths.push_back(path.string());
+    }
+
+    // Make the later files finish first so the results arrive out of order.
+    auto delay = [&params](std::string const& name) {
+        const int num = std::stoi(zeus::split(name, '_')[2]);
+        std::this_thread::sleep_for(std::chrono::milliseconds{params.num_files - num});
+    };
+
+    SECTION("Images")
+    {
+        auto fun = [&](std::string const& name, cv::Mat const& img) {
+            delay(name);
+            return img.rows;
+        };
+
+        std::vector<std::string> names;
+        auto sink = [&](std::string const& name, int rows) {
+            REQUIRE(rows == params.size.height);
+            names.push_back(name);
+        };
+
+        rad::process_images_ordered(mgr.root().string(), fun, sink, max_tokens);
+        REQUIRE(names.size() == exp_paths.size());
+        for (std::size_t i{0}; i < names.size(); ++i)
+        {
+            REQUIRE(names[i] == fs::path{exp_paths[i]}.stem().string());
+        }
+    }
+
+    SECTION("Files")
+    {
+        auto fun = [&](std::string const& path) {
+            delay(fs::path{path}.stem().string());
+            return fs::file_size(path);
+        };
+
+        std::vector<std::string> paths;
+        auto sink = [&](std::string const& path, std::uintmax_t size) {
+            REQUIRE(size == fs::file_size(path));
+            paths.push_back(path);
+        };
+
+        rad::process_files_ordered(mgr.root().string(), fun, sink);
+        REQUIRE(paths == exp_paths);
+    }
+
+    SECTION("Invalid tokens")
+    {
+        auto fun = [](std::string const&, cv::Mat const& img) {
+            return img.rows;
+        };
+        auto sink = [](std::string const&, int) {};
+        REQUIRE_THROWS(rad::process_images_ordered(mgr.root().string(), fun, sink, 0));
+    }
+}
+
+TEST_CASE("processing - process_images_prefetched", "[rad]")
+{
+    const TestFileManager::Params params;
+    const TestFileManager mgr{params};
+    static constexpr std::size_t window{4};
+
+    std::vector<std::atomic<bool>> seen_files(params.num_files);
+    auto fun = [&](std::string const& name, cv::Mat const& img) {
+        REQUIRE(img.type() == params.type);
+        REQUIRE(img.size() == params.size);
+        auto num                   = zeus::split(name, '_')[2];
+        seen_files[std::stoi(num)] = true;
+    };
+
+    SECTION("Default flags")
+    {
+        rad::process_images_prefetched(mgr.root().string(), fun, window);
+        for (auto const& seen : seen_files)
+        {
+            REQUIRE(seen);
+        }
+    }
+
+    SECTION("Invalid window")
+    {
+        REQUIRE_THROWS(rad::process_images_prefetched(mgr.root().string(), fun, 0));
+    }
+}
+
+TEST_CASE("processing - process_images_recursive", "[rad]")
+{
+    const TestFileManager::Params params;
+    const TestFileManager mgr{params};
+
+    const fs::path sub_dir = mgr.root() / "nested";
+    fs::create_directories(sub_dir);
+    const cv::Mat nested_img = cv::Mat::ones(params.size, params.type);
+    cv::imwrite((sub_dir / fmt::format("test_img_{}.jpg", params.num_files)).string(),
+                nested_img);
+
+    std::vector<std::atomic<bool>> seen_files(params.num_files + 1);
+
+    auto fun = [&seen_files, params](std::string const& name, cv::Mat const& img) {
+        REQUIRE(img.type() == params.type);
+        auto num                   = zeus::split(name, '_')[2];
+        seen_files[std::stoi(num)] = true;
+    };
+
+    SECTION("Serial")
+    {
+        rad::process_images_recursive(mgr.root().string(), fun);
+        for (auto const& seen : seen_files)
+        {
+            REQUIRE(seen);
+        }
+    }
+
+    SECTION("Parallel")
+    {
+        rad::process_images_recursive_parallel(mgr.root().string(), fun);
+        for (auto const& seen : seen_files)
+        {
+            REQUIRE(seen);
+        }
+    }
+}
+
+TEST_CASE("processing - process_files_recursive", "[rad]")
+{
+    const TestFileManager::Params params;
+    const TestFileManager mgr{params};
+
+    const fs::path sub_dir = mgr.root() / "nested";
+    fs::create_directories(sub_dir);
+    const cv::Mat nested_img = cv::Mat::ones(params.size, params.type);
+    cv::imwrite((sub_dir / fmt::format("test_img_{}.jpg", params.num_files)).string(),
+                nested_img);
+
+    std::vector<std::atomic<bool>> seen_files(params.num_files + 1);
+
+    auto fun = [&seen_files](std::string const& path) {
+        const std::string name     = fs::path{path}.stem().string();
+        auto num                   = zeus::split(name, '_')[2];
+        seen_files[std::stoi(num)] = true;
+    };
+
+    SECTION("Serial")
+    {
+        rad::process_files_recursive(mgr.root().string(), fun);
+        for (auto const& seen : seen_files)
+        {
+            REQUIRE(seen);
+        }
+    }
+
+    SECTION("Parallel")
+    {
+        rad::process_files_recursive_parallel(mgr.root().string(), fun);
+        for (auto const& seen : seen_files)
+        {
+            REQUIRE(seen);
+        }
+    }
+}
+
+TEST_CASE("processing - process_images_batched", "[rad]")
+{
+    const TestFileManager::Params params;
+    const TestFileManager mgr{params};
+    static constexpr std::size_t batch_size{4};
+
+    std::vector<std::atomic<bool>> seen_files(params.num_files);
+    std::atomic<int> num_full{0};
+    std::atomic<int> num_partial{0};
+    std::atomic<int> num_padded{0};
+
+    auto fun = [&](std::vector<std::string> const& names,
+                   std::vector<cv::Mat> const& images) {
+        REQUIRE(names.size() <= batch_size);
+        REQUIRE(images.size() >= names.size());
+        if (images.size() == batch_size)
+        {
+            ++num_full;
+        }
+        else
+        {
+            ++num_partial;
+        }
+
+        if (images.size() > names.size())
+        {
+            ++num_padded;
+        }
+
+        for (auto const& img : images)
+        {
+            REQUIRE(img.type() == params.type);
+        }
+
+        for (auto const& name : names)
+        {
+            auto num                   = zeus::split(name, '_')[2];
+            seen_files[std::stoi(num)] = true;
+        }
+    };
+
+    auto check_all_seen = [&seen_files] {
+        for (auto const& seen : seen_files)
+        {
+            REQUIRE(seen);
+        }
+    };
+
+    SECTION("Keep")
+    {
+        rad::process_images_batched(mgr.root().string(), batch_size, fun);
+        REQUIRE(num_full == 2);
+        REQUIRE(num_partial == 1);
+        check_all_seen();
+    }
+
+    SECTION("Keep - parallel")
+    {
+        rad::process_images_batched_parallel(mgr.root().string(), batch_size, fun);
+        REQUIRE(num_full == 2);
+        REQUIRE(num_partial == 1);
+        check_all_seen();
+    }
+
+    SECTION("Drop")
+    {
+        rad::process_images_batched(mgr.root().string(),
+                                    batch_size,
+                                    fun,
+                                    cv::IMREAD_COLOR,
+                                    rad::PartialBatchPolicy::drop);
+        REQUIRE(num_full == 2);
+        REQUIRE(num_partial == 0);
+    }
+
+    SECTION("Drop - parallel")
+    {
+        rad::process_images_batched_parallel(mgr.root().string(),
+                                             batch_size,
+                                             fun,
+                                             cv::IMREAD_COLOR,
+                                             rad::PartialBatchPolicy::drop);
+        REQUIRE(num_full == 2);
+        REQUIRE(num_partial == 0);
+    }
+
+    SECTION("Pad")
+    {
+        rad::process_images_batched(mgr.root().string(),
+                                    batch_size,
+                                    fun,
+                                    cv::IMREAD_COLOR,
+                                    rad::PartialBatchPolicy::pad);
+        REQUIRE(num_full == 3);
+        REQUIRE(num_padded == 1);
+        check_all_seen();
+    }
+
+    SECTION("Pad - parallel")
+    {
+        rad::process_images_batched_parallel(mgr.root().string(),
+                                             batch_size,
+                                             fun,
+                                             cv::IMREAD_COLOR,
+                                             rad::PartialBatchPolicy::pad);
+        REQUIRE(num_full == 3);
+        REQUIRE(num_padded == 1);
+        check_all_seen();
+    }
+
+    SECTION("Invalid batch size")
+    {
+        REQUIRE_THROWS(rad::process_images_batched(mgr.root().string(), 0, fun));
+    }
+}
+
+TEST_CASE("processing - process_video", "[rad]")
+{
+    const TestFileManager mgr{TestFileManager::Params{.num_files = 0}};
+    static constexpr int num_frames{30};
+    const auto path = create_video(mgr.root() / "video_a.avi", num_frames);
+
+    std::vector<std::atomic<int>> seen_frames(num_frames);
+    auto fun = [&seen_frames](std::size_t index, cv::Mat const& frame) {
+        REQUIRE_FALSE(frame.empty());
+        ++seen_frames[index];
+    };
+    auto check_seen = [&seen_frames] {
+        for (auto const& seen : seen_frames)
+        {
+            REQUIRE(seen == 1);
+        }
+    };
+
+    SECTION("Serial")
+    {
+        rad::process_video(path, fun);
+        check_seen();
+    }
+
+    SECTION("Parallel")
+    {
+        rad::process_video_parallel(path, fun, 4);
+        check_seen();
+    }
+
+    SECTION("Parallel with ordered sink")
+    {
+        auto process = [&](std::size_t index, cv::Mat const& frame) {
+            fun(index, frame);
+            return index;
+        };
+
+        std::vector<std::size_t> order;
+        rad::process_video_parallel(path,
+                                    process,
+                                    [&order](std::size_t index, std::size_t result) {
+                                        REQUIRE(index == result);
+                                        order.push_back(index);
+                                    });
+
+        REQUIRE(order.size() == static_cast<std::size_t>(num_frames));
+        for (std::size_t i{0}; i < order.size(); ++i)
+        {
+            REQUIRE(order[i] == i);
+        }
+
+        check_seen();
+    }
+
+    SECTION("Missing video")
+    {
+        REQUIRE_THROWS(rad::process_video((mgr.root() / "missing.avi").string(), fun));
+        REQUIRE_THROWS(
+            rad::process_video_parallel((mgr.root() / "missing.avi").string(), fun));
+    }
+
+}
+
+TEST_CASE("processing - process_videos_parallel", "[rad]")
+{
+    const TestFileManager mgr{TestFileManager::Params{.num_files = 0}};
+    static constexpr int num_frames{15};
+    const std::vector<std::string> paths{
+        create_video(mgr.root() / "video_a.avi", num_frames),
+        create_video(mgr.root() / "video_b.avi", num_frames),
+    };
+
+    std::atomic<int> frames_a{0};
+    std::atomic<int> frames_b{0};
+    rad::process_videos_parallel(
+        paths,
+        [&](std::string const& name, std::size_t, cv::Mat const& frame) {
+            REQUIRE_FALSE(frame.empty());
+            ++(name == "video_a" ? frames_a : frames_b);
+        });
+
+    REQUIRE(frames_a == num_frames);
+    REQUIRE(frames_b == num_frames);
+}
@@ -4,13 +4,19 @@
 #include <fmt/format.h>
 #include <opencv2/core/hal/interface.h>
 #include <opencv2/core/types.hpp>
+#include <opencv2/imgcodecs.hpp>
 #include <rad/processing_util.hpp>
 #include <zeus/platform.hpp> // NOLINT(misc-include-cleaner)
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <filesystem>
+#include <fstream>
+#include <limits>
 #include <string>
 #include <unordered_set>
+#include <vector>
 
 namespace fs = std::filesystem;
 
@@ -36,6 +42,296 @@ TEST_CASE("[processing_util] - get_file_paths_from_root", "[rad]")
     }
 }
 
+TEST_CASE("[processing_util] - has_image_extension", "[rad]")
+{
+    const rad::ImageFilter filter;
+
+    REQUIRE(rad::has_image_extension("img.jpg", filter.extensions));
+    REQUIRE(rad::has_image_extension("img.JPG", filter.extensions));
+    REQUIRE(rad::has_image_extension("img.png", filter.extensions));
+    REQUIRE(rad::has_image_extension("dir/img.tiff", filter.extensions));
+    REQUIRE_FALSE(rad::has_image_extension("img.json", filter.extensions));
+    REQUIRE_FALSE(rad::has_image_extension("img.txt", filter.extensions));
+    REQUIRE_FALSE(rad::has_image_extension(".DS_Store", filter.extensions));
+    REQUIRE_FALSE(rad::has_image_extension("img", filter.extensions));
+}
+
+TEST_CASE("[processing_util] - has_image_signature", "[rad]")
+{
+    SECTION("Buffers")
+    {
+        const std::vector<std::uint8_t> jpg{0xFF, 0xD8, 0xFF, 0xE0};
+        const std::vector<std::uint8_t> png{0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+        const std::vector<std::uint8_t> ppm{'P', '6', '\n'};
+        const std::vector<std::uint8_t> json{'{', '"', 'a', '"'};
+        const std::vector<std::uint8_t> short_png{0x89, 'P', 'N'};
+
+        REQUIRE(rad::has_image_signature(jpg.data(), jpg.size()));
+        REQUIRE(rad::has_image_signature(png.data(), png.size()));
+        REQUIRE(rad::has_image_signature(ppm.data(), ppm.size()));
+        REQUIRE_FALSE(rad::has_image_signature(json.data(), json.size()));
+        REQUIRE_FALSE(rad::has_image_signature(short_png.data(), short_png.size()));
+    }
+
+    SECTION("Files")
+    {
+        const TestFileManager mgr{TestFileManager::Params{.num_files = 1}};
+        const fs::path fake = mgr.root() / "fake.jpg";
+        std::ofstream{fake} << "not an image";
+
+        REQUIRE(rad::has_image_signature(mgr.root() / "test_img_0.jpg"));
+        REQUIRE_FALSE(rad::has_image_signature(fake));
+        REQUIRE_FALSE(rad::has_image_signature(mgr.root() / "missing.jpg"));
+    }
+}
+
+TEST_CASE("[processing_util] - is_image_file", "[rad]")
+{
+    const TestFileManager mgr{TestFileManager::Params{.num_files = 1}};
+    const fs::path img  = mgr.root() / "test_img_0.jpg";
+    const fs::path fake = mgr.root() / "fake.jpg";
+    const fs::path json = mgr.root() / "meta.json";
+    std::ofstream{fake} << "not an image";
+    std::ofstream{json} << "{}";
+
+    SECTION("Default filter")
+    {
+        const rad::ImageFilter filter;
+        REQUIRE(rad::is_image_file(img, filter));
+        REQUIRE_FALSE(rad::is_image_file(fake, filter));
+        REQUIRE_FALSE(rad::is_image_file(json, filter));
+    }
+
+    SECTION("Extensions only")
+    {
+        const rad::ImageFilter filter{.check_signature = false};
+        REQUIRE(rad::is_image_file(img, filter));
+        REQUIRE(rad::is_image_file(fake, filter));
+        REQUIRE_FALSE(rad::is_image_file(json, filter));
+    }
+
+    SECTION("Custom extensions")
+    {
+        const rad::ImageFilter filter{.extensions = {".png"}};
+        REQUIRE_FALSE(rad::is_image_file(img, filter));
+    }
+}
+
+TEST_CASE("[processing_util] - get_file_paths_from_root with filter", "[rad]")
+{
+    const TestFileManager::Params params;
+    const TestFileManager mgr{params};
+    std::ofstream{mgr.root() / "meta.json"} << "{}";
+    std::ofstream{mgr.root() / "notes.txt"} << "notes";
+    std::ofstream{mgr.root() / ".DS_Store"} << "store";
+    std::ofstream{mgr.root() / "fake.jpg"} << "not an image";
+
+    REQUIRE(rad::get_file_paths_from_root(mgr.root().string()).size() == 14);
+
+    auto files = rad::get_file_paths_from_root(mgr.root().string(), rad::ImageFilter{});
+    REQUIRE(files.size() == static_cast<std::size_t>(params.num_files));
+    for (auto const& file : files)
+    {
+        REQUIRE(file.extension() == ".jpg");
+        REQUIRE(file.stem() != "fake");
+    }
+}
+
+TEST_CASE("[processing_util] - sort_by_file_size", "[rad]")
+{
+    const TestFileManager mgr{TestFileManager::Params{.num_files = 0}};
+    std::vector<fs::path> files;
+    for (std::size_t i{0}; i < 5; ++i)
+    {
+        const fs::path p = mgr.root() / fmt::format("file_{}.bin", i);
+        std::ofstream{p} << std::string((i + 1) * 10, 'x');
+        files.push_back(p);
+    }
+
+    SECTION("get_file_sizes")
+    {
+        auto sizes = rad::get_file_sizes(files);
+        REQUIRE(sizes.size() == files.size());
+        for (std::size_t i{0}; i < sizes.size(); ++i)
+        {
+            REQUIRE(sizes[i] == (i + 1) * 10);
+        }
+    }
+
+    SECTION("sort_by_file_size")
+    {
+        auto sorted = rad::sort_by_file_size(files);
+        REQUIRE(sorted.size() == files.size());
+        for (std::size_t i{0}; i < sorted.size(); ++i)
+        {
+            REQUIRE(sorted[i] == files[files.size() - i - 1]);
+        }
+    }
+
+    SECTION("partition_by_file_size")
+    {
+        // Sizes are 10, 20, 30, 40, 50, which split into {50, 20, 10} and {40, 30}.
+        auto chunks = rad::partition_by_file_size(files, 2);
+        REQUIRE(chunks.size() == 2);
+
+        auto total = [](std::vector<fs::path> const& chunk) {
+            std::uintmax_t sum{0};
+            for (auto const& p : chunk)
+            {
+                sum += fs::file_size(p);
+            }
+            return sum;
+        };
+
+        REQUIRE(chunks[0].size() + chunks[1].size() == files.size());
+        REQUIRE(total(chunks[0]) == 80);
+        REQUIRE(total(chunks[1]) == 70);
+    }
+
+    SECTION("partition_by_file_size - more chunks than files")
+    {
+        auto chunks = rad::partition_by_file_size(files, 10);
+        REQUIRE(chunks.size() == files.size());
+        for (auto const& chunk : chunks)
+        {
+            REQUIRE(chunk.size() == 1);
+        }
+    }
+
+    SECTION("partition_by_file_size - invalid chunks")
+    {
+        REQUIRE_THROWS(rad::partition_by_file_size(files, 0));
+    }
+}
+
+TEST_CASE("[processing_util] - select_shard", "[rad]")
+{
+    const TestFileManager::Params params{.num_files = 50};
+    const TestFileManager mgr{params};
+    const auto root  = mgr.root().string();
+    const auto files = rad::get_file_paths_from_root(root);
+
+    SECTION("fnv1a_hash")
+    {
+        REQUIRE(rad::fnv1a_hash("") == 14695981039346656037ULL);
+        REQUIRE(rad::fnv1a_hash("a") == 0xaf63dc4c8601ec8cULL);
+        REQUIRE(rad::fnv1a_hash("foobar") == 0x85944171f73967e8ULL);
+    }
+
+    SECTION("Disjoint and complete")
+    {
+        static constexpr std::size_t num_shards{4};
+        std::vector<fs::path> all;
+        for (std::size_t i{0}; i < num_shards; ++i)
+        {
+            const rad::ShardSpec spec{.index = i, .count = num_shards};
+            auto shard = rad::select_shard(files, root, spec);
+            all.insert(all.end(), shard.begin(), shard.end());
+        }
+
+        std::ranges::sort(all);
+        auto sorted = files;
+        std::ranges::sort(sorted);
+        REQUIRE(all == sorted);
+    }
+
+    SECTION("Stable across roots")
+    {
+        const rad::ShardSpec shard{.index = 1, .count = 3};
+        auto a = rad::select_shard(files, root, shard);
+        auto b = rad::select_shard(files, root + "/", shard);
+        REQUIRE(a == b);
+
+        for (auto const& file : a)
+        {
+            REQUIRE(rad::is_in_shard(fs::path{"/other/mount"} / file.filename(),
+                                     "/other/mount",
+                                     shard));
+        }
+    }
+
+    SECTION("Single shard")
+    {
+        REQUIRE(rad::select_shard(files, root, {}) == files);
+    }
+
+    SECTION("Invalid shard")
+    {
+        REQUIRE_THROWS(rad::select_shard(files, root, {.index = 0, .count = 0}));
+        REQUIRE_THROWS(rad::select_shard(files, root, {.index = 2, .count = 2}));
+    }
+}
+
+TEST_CASE("[processing_util] - read_image_header", "[rad]")
+{
+    TestFileManager::Params params{.num_files = 1, .size = cv::Size{48, 32}};
+
+    SECTION("jpg")
+    {
+        const TestFileManager mgr{params};
+        auto header = rad::read_image_header(mgr.root() / "test_img_0.jpg");
+        REQUIRE(header);
+        REQUIRE(header->width == 48);
+        REQUIRE(header->height == 32);
+        REQUIRE(header->channels == 3);
+        REQUIRE(header->depth == CV_8U);
+        REQUIRE(header->format == rad::ImageFormat::jpeg);
+    }
+
+    SECTION("png")
+    {
+        params.ext  = "png";
+        params.type = CV_16UC3;
+        const TestFileManager mgr{params};
+        auto header = rad::read_image_header(mgr.root() / "test_img_0.png");
+        REQUIRE(header);
+        REQUIRE(header->width == 48);
+        REQUIRE(header->height == 32);
+        REQUIRE(header->channels == 3);
+        REQUIRE(header->depth == CV_16U);
+        REQUIRE(header->format == rad::ImageFormat::png);
+    }
+
+    SECTION("bmp")
+    {
+        params.ext = "bmp";
+        const TestFileManager mgr{params};
+        auto header = rad::read_image_header(mgr.root() / "test_img_0.bmp");
+        REQUIRE(header);
+        REQUIRE(header->width == 48);
+        REQUIRE(header->height == 32);
+        REQUIRE(header->channels == 3);
+        REQUIRE(header->format == rad::ImageFormat::bmp);
+    }
+
+    SECTION("Unknown format")
+    {
+        const TestFileManager mgr{params};
+        const fs::path p = mgr.root() / "notes.txt";
+        std::ofstream{p} << "not an image";
+        REQUIRE_FALSE(rad::read_image_header(p));
+    }
+}
+
+TEST_CASE("[processing_util] - estimate_decoded_size", "[rad]")
+{
+    const TestFileManager::Params params{.num_files = 1,
+                                         .ext       = "png",
+                                         .size      = cv::Size{48, 32},
+                                         .type      = CV_16UC3};
+    const TestFileManager mgr{params};
+    const fs::path p = mgr.root() / "test_img_0.png";
+
+    REQUIRE(rad::estimate_decoded_size(p, cv::IMREAD_UNCHANGED) == 48 * 32 * 3 * 2);
+    REQUIRE(rad::estimate_decoded_size(p, cv::IMREAD_COLOR) == 48 * 32 * 3);
+    REQUIRE(rad::estimate_decoded_size(p, cv::IMREAD_GRAYSCALE) == 48 * 32);
+    REQUIRE(rad::estimate_decoded_size(p, cv::IMREAD_REDUCED_COLOR_2) == 24 * 16 * 3);
+
+    const fs::path unknown = mgr.root() / "notes.txt";
+    std::ofstream{unknown} << "0123456789";
+    REQUIRE(rad::estimate_decoded_size(unknown, cv::IMREAD_COLOR) == 100);
+}
+
 TEST_CASE("[processing_util] - load_image", "[rad]")
 {
     TestFileManager::Params params{.num_files = 1};
@@ -81,6 +377,136 @@ TEST_CASE("[processing_util] - load_image", "[rad]")
         REQUIRE(img.type() == params.type);
     }
 #endif
+
+    SECTION("With filter")
+    {
+        const TestFileManager mgr{params};
+        const fs::path fake = mgr.root() / "fake.jpg";
+        std::ofstream{fake} << "not an image";
+
+        const fs::path p = mgr.root() / fmt::format("{}.{}", exp_name, params.ext);
+        auto [name, img] =
+            rad::load_image(p.string(), cv::IMREAD_COLOR, rad::ImageFilter{});
+        REQUIRE(name == exp_name);
+        REQUIRE(img.size() == params.size);
+
+        auto [fake_name, fake_img] =
+            rad::load_image(fake.string(), cv::IMREAD_COLOR, rad::ImageFilter{});
+        REQUIRE(fake_name == "fake");
+        REQUIRE(fake_img.empty());
+    }
+
+    SECTION("Mapped")
+    {
+        const TestFileManager mgr{params};
+
+        const fs::path p = mgr.root() / fmt::format("{}.{}", exp_name, params.ext);
+        auto [name, img] =
+            rad::load_image(p.string(), cv::IMREAD_COLOR, rad::ImageReadMode::mapped);
+        REQUIRE(name == exp_name);
+        REQUIRE(img.size() == params.size);
+        REQUIRE(img.type() == params.type);
+
+        auto [missing_name, missing_img] = rad::load_image(
+            (mgr.root() / "missing.jpg").string(),
+            cv::IMREAD_COLOR,
+            rad::ImageReadMode::mapped);
+        REQUIRE(missing_name == "missing");
+        REQUIRE(missing_img.empty());
+    }
+}
+
+TEST_CASE("[processing_util] - load_image with long edge", "[rad]")
+{
+    const TestFileManager::Params params{.num_files = 1, .size = cv::Size{128, 64}};
+    const TestFileManager mgr{params};
+    const fs::path p = mgr.root() / "test_img_0.jpg";
+
+    SECTION("Reduced decode")
+    {
+        auto [name, img] = rad::load_image(p.string(), cv::IMREAD_COLOR, 30);
+        REQUIRE(name == "test_img_0");
+        REQUIRE(img.size() == cv::Size{30, 15});
+        REQUIRE(img.type() == params.type);
+    }
+
+    SECTION("Exact factor")
+    {
+        auto [name, img] = rad::load_image(p.string(), cv::IMREAD_COLOR, 16);
+        REQUIRE(img.size() == cv::Size{16, 8});
+    }
+
+    SECTION("Grayscale")
+    {
+        auto [name, img] = rad::load_image(p.string(), cv::IMREAD_GRAYSCALE, 50);
+        REQUIRE(img.size() == cv::Size{50, 25});
+        REQUIRE(img.channels() == 1);
+    }
+
+    SECTION("Smaller than target")
+    {
+        auto [name, img] = rad::load_image(p.string(), cv::IMREAD_COLOR, 256);
+        REQUIRE(img.size() == params.size);
+    }
+
+    SECTION("Other formats")
+    {
+        // Halving 1023 rounds down to 511, which would undershoot the target if the
+        // PNG were decoded at reduced scale.
+        const fs::path png = mgr.root() / "wide.png";
+        cv::imwrite(png.string(), cv::Mat::ones(cv::Size{1023, 16}, params.type));
+        auto [name, img] = rad::load_image(png.string(), cv::IMREAD_COLOR, 512);
+        REQUIRE(img.size() == cv::Size{512, 8});
+    }
+
+    SECTION("Invalid long edge")
+    {
+        REQUIRE_THROWS(rad::load_image(p.string(), cv::IMREAD_COLOR, 0));
+    }
+}
+
+TEST_CASE("[processing_util] - read_file_bytes", "[rad]")
+{
+    const TestFileManager mgr{TestFileManager::Params{.num_files = 1}};
+    const fs::path p = mgr.root() / "test_img_0.jpg";
+
+    SECTION("Existing file")
+    {
+        auto bytes = rad::read_file_bytes(p.string());
+        REQUIRE(bytes.size() == fs::file_size(p));
+    }
+
+    SECTION("Missing file")
+    {
+        REQUIRE_THROWS(rad::read_file_bytes((mgr.root() / "missing.jpg").string()));
+    }
+}
+
+TEST_CASE("[processing_util] - decode_image", "[rad]")
+{
+    const TestFileManager::Params params{.num_files = 1};
+    const TestFileManager mgr{params};
+    const fs::path p = mgr.root() / "test_img_0.jpg";
+
+    SECTION("Valid buffer")
+    {
+        auto img = rad::decode_image(rad::read_file_bytes(p.string()), cv::IMREAD_COLOR);
+        REQUIRE(img.size() == params.size);
+        REQUIRE(img.type() == params.type);
+    }
+
+    SECTION("Empty buffer")
+    {
+        REQUIRE(rad::decode_image({}, cv::IMREAD_COLOR).empty());
+    }
+
+    SECTION("Oversized buffer")
+    {
+        // The size is rejected before the buffer is ever read.
+        const std::vector<std::uint8_t> bytes(1);
+        const auto size = static_cast<std::size_t>(std::numeric_limits<int>::max()) + 1;
+        REQUIRE_THROWS(rad::decode_image(bytes.data(), size, cv::IMREAD_COLOR));
+    }
 }
 
 TEST_CASE("[processing_util] - create_result_dir", "[rad]")
@@ -0,0 +1,73 @@
+#include "test_file_manager.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <opencv2/core/mat.hpp>
+#include <rad/processing.hpp>
+#include <rad/profiling.hpp>
+
+#include <cstddef>
+#include <string>
+
+TEST_CASE("[profiling] - get_summary", "[rad]")
+{
+    using rad::profiling::Stage;
+
+    const TestFileManager::Params params;
+    const TestFileManager mgr{params};
+    const auto num_files = static_cast<std::size_t>(params.num_files);
+
+    auto fun = [](std::string const&, cv::Mat const&) {};
+    rad::profiling::reset();
+
+    SECTION("Serial")
+    {
+        rad::process_images(mgr.root().string(), fun);
+
+        auto summary = rad::profiling::get_summary();
+        if constexpr (rad::profiling::is_enabled())
+        {
+            REQUIRE(summary[Stage::load].count == num_files);
+            REQUIRE(summary[Stage::process].count == num_files);
+            REQUIRE(summary[Stage::load].p50 <= summary[Stage::load].p90);
+            REQUIRE(summary[Stage::load].p99 <= summary[Stage::load].max);
+            REQUIRE(summary.num_images == num_files);
+            REQUIRE(summary.bytes_read > 0);
+            REQUIRE(summary.images_per_second > 0.0);
+        }
+        else
+        {
+            REQUIRE(summary.num_images == 0);
+            REQUIRE(summary[Stage::load].count == 0);
+        }
+    }
+
+    SECTION("Pipelined")
+    {
+        rad::process_images_pipelined(mgr.root().string(), fun, 4);
+
+        auto summary = rad::profiling::get_summary();
+        if constexpr (rad::profiling::is_enabled())
+        {
+            REQUIRE(summary[Stage::read].count == num_files);
+            REQUIRE(summary[Stage::decode].count == num_files);
+            REQUIRE(summary[Stage::process].count == num_files);
+            REQUIRE(summary[Stage::load].count == 0);
+            REQUIRE(summary.num_images == num_files);
+        }
+        else
+        {
+            REQUIRE(summary.num_images == 0);
+        }
+    }
+
+    SECTION("Reset")
+    {
+        rad::process_images(mgr.root().string(), fun);
+        rad::profiling::reset();
+
+        auto summary = rad::profiling::get_summary();
+        REQUIRE(summary.num_images == 0);
+        REQUIRE(summary.bytes_read == 0);
+        REQUIRE_FALSE(rad::profiling::format_summary(summary).empty());
+    }
+}
@@ -0,0 +1,91 @@
+#include <catch2/catch_test_macros.hpp>
+#include <oneapi/tbb/parallel_for.h>
+#include <rad/progress.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+TEST_CASE("[progress] - ProgressContext", "[rad]")
+{
+    SECTION("Counters")
+    {
+        rad::ProgressContext progress;
+        progress.start(10);
+        progress.record_processed(100);
+        progress.record_processed(50);
+        progress.record_failed();
+
+        auto snapshot = progress.snapshot();
+        REQUIRE(snapshot.total == 10);
+        REQUIRE(snapshot.processed == 2);
+        REQUIRE(snapshot.failed == 1);
+        REQUIRE(snapshot.remaining == 7);
+        REQUIRE(snapshot.bytes_read == 150);
+    }
+
+    SECTION("Concurrent updates")
+    {
+        static constexpr std::size_t num_items{1000};
+        rad::ProgressContext progress;
+        progress.start(num_items);
+        oneapi::tbb::parallel_for(std::size_t{0}, num_items, [&](std::size_t i) {
+            if (i % 10 == 0)
+            {
+                progress.record_failed();
+            }
+            else
+            {
+                progress.record_processed(1);
+            }
+        });
+
+        auto snapshot = progress.snapshot();
+        REQUIRE(snapshot.processed == 900);
+        REQUIRE(snapshot.failed == 100);
+        REQUIRE(snapshot.remaining == 0);
+        REQUIRE(snapshot.bytes_read == 900);
+    }
+
+    SECTION("Throttled callback")
+    {
+        std::vector<rad::ProgressSnapshot> reports;
+        rad::ProgressContext progress{
+            [&reports](rad::ProgressSnapshot const& snapshot) {
+                reports.push_back(snapshot);
+            },
+            std::chrono::hours{1}};
+
+        progress.start(3);
+        progress.record_processed(1);
+        progress.record_processed(1);
+        REQUIRE(reports.empty());
+
+        progress.finish();
+        REQUIRE(reports.size() == 1);
+        REQUIRE(reports.back().processed == 2);
+    }
+
+    SECTION("Unthrottled callback")
+    {
+        std::size_t num_reports{0};
+        rad::ProgressContext progress{
+            [&num_reports](rad::ProgressSnapshot const&) {
+                ++num_reports;
+            },
+            std::chrono::milliseconds{0}};
+
+        progress.start(3);
+        progress.record_processed(1);
+        progress.record_failed();
+        REQUIRE(num_reports >= 1);
+    }
+
+    SECTION("Cancellation")
+    {
+        rad::ProgressContext progress;
+        REQUIRE_FALSE(progress.is_cancelled());
+        progress.cancel();
+        REQUIRE(progress.is_cancelled());
+    }
+}
@@ -0,0 +1,112 @@
+#include <catch2/catch_test_macros.hpp>
+#include <opencv2/core/hal/interface.h>
+#include <opencv2/core/mat.hpp>
+#include <rad/processing_util.hpp>
+#include <rad/result_cache.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    void write_file(fs::path const& path, std::string const& contents)
+    {
+        std::ofstream stream{path, std::ios::binary};
+        stream << contents;
+    }
+} // namespace
+
+TEST_CASE("[result_cache] - xxhash64", "[rad]")
+{
+    REQUIRE(rad::xxhash64("", 0) == 0xEF46DB3751D8E999ULL);
+    REQUIRE(rad::xxhash64("a", 0) == 0xD24EC4F1A98C6E5BULL);
+    REQUIRE(rad::xxhash64("abc", 0) == 0x44BC2CF5AD770999ULL);
+    REQUIRE(rad::xxhash64("Nobody inspects the spammish repetition", 0)
+            == 0xFBCEA83C8A378BF1ULL);
+    REQUIRE(rad::xxhash64("abc", 1) != rad::xxhash64("abc", 0));
+}
+
+TEST_CASE("[result_cache] - ResultCache", "[rad]")
+{
+    const fs::path root = fs::absolute("./test_cache");
+    fs::create_directories(root);
+    write_file(root / "input_a.txt", "first input");
+    write_file(root / "input_b.txt", "first input");
+    write_file(root / "input_c.txt", "second input");
+    write_file(root / "result.txt", "result");
+
+    SECTION("Keys")
+    {
+        const rad::ResultCache cache{root / "cache", "v1"};
+        const rad::ResultCache other{root / "cache", "v2"};
+
+        // Keys depend only on the file contents and the version.
+        const auto key = cache.get_key(root / "input_a.txt");
+        REQUIRE(key == cache.get_key(root / "input_b.txt"));
+        REQUIRE(key != cache.get_key(root / "input_c.txt"));
+        REQUIRE(key != other.get_key(root / "input_a.txt"));
+
+        // The context is part of the key.
+        const auto color_key = cache.get_key(root / "input_a.txt", "app:1");
+        REQUIRE(color_key == cache.get_key(root / "input_b.txt", "app:1"));
+        REQUIRE(color_key != key);
+        REQUIRE(color_key != cache.get_key(root / "input_a.txt", "app:0"));
+        REQUIRE(color_key != cache.get_key(root / "input_a.txt", "other:1"));
+    }
+
+    SECTION("Store and restore")
+    {
+        rad::ResultCache cache{root / "cache", "v1"};
+        const auto key = cache.get_key(root / "input_a.txt");
+        REQUIRE_FALSE(cache.restore(key, root / "restored.txt"));
+        REQUIRE_FALSE(fs::exists(root / "restored.txt"));
+
+        cache.store(key, root / "result.txt");
+        REQUIRE(cache.num_stores() == 1);
+        REQUIRE(cache.restore(key, root / "restored.txt"));
+        REQUIRE(cache.num_hits() == 1);
+        REQUIRE(rad::read_file_bytes((root / "restored.txt").string())
+                == rad::read_file_bytes((root / "result.txt").string()));
+
+        // Restoring over an existing file replaces it.
+        fs::remove(root / "restored.txt");
+        write_file(root / "restored.txt", "stale");
+        REQUIRE(cache.restore(key, root / "restored.txt"));
+        REQUIRE(rad::read_file_bytes((root / "restored.txt").string())
+                == rad::read_file_bytes((root / "result.txt").string()));
+
+        // Rewriting the original result doesn't touch the entry.
+        write_file(root / "result.txt", "new result");
+        REQUIRE(cache.restore(key, root / "restored.txt"));
+        const auto bytes = rad::read_file_bytes((root / "restored.txt").string());
+        REQUIRE(std::string{bytes.begin(), bytes.end()} == "result");
+
+        // Entries persist across instances.
+        rad::ResultCache reopened{root / "cache", "v1"};
+        REQUIRE(reopened.restore(key, root / "reopened.txt"));
+    }
+
+    SECTION("Saving over a restored result")
+    {
+        rad::ResultCache cache{root / "cache", "v1"};
+        const auto key         = cache.get_key(root / "input_a.txt");
+        const auto destination = root / "app" / "img.png";
+        rad::create_result_dir(root.string(), "app");
+        rad::save_result(cv::Mat::zeros(8, 8, CV_8UC1), root.string(), "app", "img.png");
+        cache.store(key, destination);
+        const auto stored = rad::read_file_bytes(destination.string());
+
+        // The restored file may be a hard link to the entry, which save_result must not
+        // write through.
+        REQUIRE(cache.restore(key, destination));
+        rad::save_result(cv::Mat::ones(16, 16, CV_8UC1), root.string(), "app", "img.png");
+        REQUIRE(cache.restore(key, root / "check.png"));
+        REQUIRE(rad::read_file_bytes((root / "check.png").string()) == stored);
+    }
+
+    fs::remove_all(root);
+}
@@ -0,0 +1,126 @@
+#include "tar_writer.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/format.h>
+#include <rad/tar_archive.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+TEST_CASE("[tar_archive] - TarArchive", "[rad]")
+{
+    const fs::path root = fs::absolute("./test_tar");
+    fs::create_directories(root);
+    const auto path = root / "archive.tar";
+
+    auto get_contents = [](rad::TarArchive const& archive, rad::TarMember const& member) {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        return std::string{reinterpret_cast<char const*>(archive.data(member)),
+                           member.size};
+    };
+
+    SECTION("Regular files")
+    {
+        TarWriter writer;
+        writer.add_directory("images/");
+        writer.add_file("images/a.txt", "first");
+        writer.add_file("images/b.txt", std::string(1000, 'b'));
+        writer.add_file("empty.txt", "");
+        writer.write(path);
+
+        const rad::TarArchive archive{path};
+        auto const& members = archive.members();
+        REQUIRE(members.size() == 3);
+        REQUIRE(members[0].name == "images/a.txt");
+        REQUIRE(get_contents(archive, members[0]) == "first");
+        REQUIRE(members[1].name == "images/b.txt");
+        REQUIRE(get_contents(archive, members[1]) == std::string(1000, 'b'));
+        REQUIRE(members[2].name == "empty.txt");
+        REQUIRE(members[2].size == 0);
+    }
+
+    SECTION("Long names")
+    {
+        const std::string long_name = std::string(150, 'd') + "/" + std::string(120, 'f');
+
+        TarWriter writer;
+        writer.add_gnu_long_name_file(long_name, "gnu");
+        writer.add_pax_file(long_name + ".pax", "pax");
+        writer.add_file("short.txt", "short");
+        writer.write(path);
+
+        const rad::TarArchive archive{path};
+        auto const& members = archive.members();
+        REQUIRE(members.size() == 3);
+        REQUIRE(members[0].name == long_name);
+        REQUIRE(get_contents(archive, members[0]) == "gnu");
+        REQUIRE(members[1].name == long_name + ".pax");
+        REQUIRE(get_contents(archive, members[1]) == "pax");
+
+        // The overrides only apply to the entry that follows them.
+        REQUIRE(members[2].name == "short.txt");
+    }
+
+    SECTION("Empty archive")
+    {
+        const TarWriter writer;
+        writer.write(path);
+
+        const rad::TarArchive archive{path};
+        REQUIRE(archive.members().empty());
+    }
+
+    SECTION("Corrupted archive")
+    {
+        TarWriter writer;
+        writer.add_file("a.txt", std::string(2000, 'a'));
+        auto bytes = writer.bytes();
+
+        auto write_bytes = [&path](std::vector<std::uint8_t> const& data) {
+            std::ofstream stream{path, std::ios::binary};
+            stream.write(reinterpret_cast<char const*>(data.data()), // NOLINT
+                         static_cast<std::streamsize>(data.size()));
+        };
+
+        // Truncated contents.
+        write_bytes({bytes.begin(), bytes.begin() + 1024});
+        REQUIRE_THROWS(rad::TarArchive{path});
+
+        // Base-256 sizes that would wrap the offsets around, or that don't fit in a
+        // std::size_t at all.
+        auto with_size = [&bytes](std::vector<std::uint8_t> const& field) {
+            auto data = bytes;
+            std::ranges::copy(field, data.begin() + 124);
+            std::fill(data.begin() + 148, data.begin() + 156, ' ');
+            const auto checksum =
+                std::accumulate(data.begin(), data.begin() + 512, std::size_t{0});
+            std::ranges::copy(fmt::format("{:06o}", checksum), data.begin() + 148);
+            data[154] = 0;
+            return data;
+        };
+
+        write_bytes(with_size(
+            {0x80, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFE, 0x00}));
+        REQUIRE_THROWS(rad::TarArchive{path});
+
+        write_bytes(with_size(
+            {0x80, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}));
+        REQUIRE_THROWS(rad::TarArchive{path});
+
+        // Bad checksum.
+        bytes[0] = 'b';
+        write_bytes(bytes);
+        REQUIRE_THROWS(rad::TarArchive{path});
+    }
+
+    fs::remove_all(root);
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Minimal tar writer used to build archives for the tests.
+class TarWriter
+{
+public:
+    static constexpr std::size_t block_size{512};
+
+    void add_file(std::string_view name, std::vector<std::uint8_t> const& bytes)
+    {
+        add_entry(name, '0', bytes);
+    }
+
+    void add_file(std::string_view name, std::string_view contents)
+    {
+        add_file(name, std::vector<std::uint8_t>{contents.begin(), contents.end()});
+    }
+
+    void add_directory(std::string_view name)
+    {
+        add_entry(name, '5', {});
+    }
+
+    // Stores the name in a GNU long name entry, as GNU tar does for names that don't
+    // fit in the header.
+    void add_gnu_long_name_file(std::string_view name, std::string_view contents)
+    {
+        std::vector<std::uint8_t> long_name{name.begin(), name.end()};
+        long_name.push_back(0);
+        add_entry("././@LongLink", 'L', long_name);
+        add_file(name.substr(0, 99), contents);
+    }
+
+    // Stores the name in a pax extended header, as POSIX tar does.
+    void add_pax_file(std::string_view name, std::string_view contents)
+    {
+        // The length prefix counts itself, so find the length that is consistent.
+        const auto body = fmt::format(" path={}\n", name);
+        std::size_t length{body.size()};
+        while (fmt::format("{}{}", length, body).size() != length)
+        {
+            ++length;
+        }
+
+        const auto record = fmt::format("{}{}", length, body);
+        add_entry("PaxHeader", 'x', {record.begin(), record.end()});
+        add_file("truncated_name", contents);
+    }
+
+    void write(std::filesystem::path const& path) const
+    {
+        std::vector<std::uint8_t> bytes{m_bytes};
+        bytes.resize(bytes.size() + (2 * block_size), 0);
+
+        std::ofstream stream{path, std::ios::binary};
+        stream.write(reinterpret_cast<char const*>(bytes.data()), // NOLINT
+                     static_cast<std::streamsize>(bytes.size()));
+    }
+
+    [[nodiscard]]
+    std::vector<std::uint8_t> const& bytes() const
+    {
+        return m_bytes;
+    }
+
+private:
+    void
+    add_entry(std::string_view name, char type, std::vector<std::uint8_t> const& data)
+    {
+        std::vector<std::uint8_t> header(block_size, 0);
+        auto put = [&header](std::size_t offset, std::string_view value) {
+            std::ranges::copy(value,
+                              header.begin() + static_cast<std::ptrdiff_t>(offset));
+        };
+
+        put(0, name.substr(0, 100));
+        put(100, "0000644");
+        put(108, "0000000");
+        put(116, "0000000");
+        put(124, fmt::format("{:011o}", data.size()));
+        put(136, "00000000000");
+        put(148, "        ");
+        header[156] = static_cast<std::uint8_t>(type);
+        put(257, "ustar");
+        put(263, "00");
+
+        std::size_t checksum{0};
+        for (auto c : header)
+        {
+            checksum += c;
+        }
+        put(148, fmt::format("{:06o}", checksum));
+        header[154] = 0;
+
+        m_bytes.insert(m_bytes.end(), header.begin(), header.end());
+        m_bytes.insert(m_bytes.end(), data.begin(), data.end());
+        const auto padding = (block_size - (data.size() % block_size)) % block_size;
+        m_bytes.resize(m_bytes.size() + padding, 0);
+    }
+
+    std::vector<std::uint8_t> m_bytes;
+};
@@ -0,0 +1,135 @@
+#include <catch2/catch_test_macros.hpp>
+#include <opencv2/core/hal/interface.h>
+#include <opencv2/core/mat.hpp>
+#include <opencv2/core/types.hpp>
+#include <rad/processing_util.hpp>
+#include <rad/tiled_raster.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    std::vector<std::uint8_t> make_raster_bytes(cv::Size size, std::size_t offset)
+    {
+        std::vector<std::uint8_t> bytes(offset, 0);
+        for (int y{0}; y < size.height; ++y)
+        {
+            for (int x{0}; x < size.width; ++x)
+            {
+                bytes.push_back(static_cast<std::uint8_t>((x + (y * 7)) % 256));
+            }
+        }
+
+        return bytes;
+    }
+
+    void write_bytes(fs::path const& path, std::vector<std::uint8_t> const& bytes)
+    {
+        std::ofstream stream{path, std::ios::binary};
+        stream.write(reinterpret_cast<char const*>(bytes.data()), // NOLINT
+                     static_cast<std::streamsize>(bytes.size()));
+    }
+} // namespace
+
+TEST_CASE("[tiled_raster] - make_tiles", "[rad]")
+{
+    const cv::Size image_size{100, 70};
+    const cv::Size tile_size{32, 32};
+    static constexpr int overlap{4};
+
+    const auto tiles = rad::make_tiles(image_size, tile_size, overlap);
+    REQUIRE(tiles.size() == 4 * 3);
+
+    // Every pixel belongs to exactly one core, and every roi contains its core plus
+    // the overlap wherever the image bounds allow it.
+    std::vector<int> coverage(static_cast<std::size_t>(image_size.area()), 0);
+    const cv::Rect bounds{0, 0, image_size.width, image_size.height};
+    for (auto const& tile : tiles)
+    {
+        REQUIRE((tile.roi & tile.core) == tile.core);
+        REQUIRE((tile.roi & bounds) == tile.roi);
+        REQUIRE(tile.roi.x == std::max(tile.core.x - overlap, 0));
+        REQUIRE(tile.roi.y == std::max(tile.core.y - overlap, 0));
+
+        for (int y{tile.core.y}; y < tile.core.y + tile.core.height; ++y)
+        {
+            for (int x{tile.core.x}; x < tile.core.x + tile.core.width; ++x)
+            {
+                ++coverage[static_cast<std::size_t>((y * image_size.width) + x)];
+            }
+        }
+    }
+
+    REQUIRE(std::ranges::all_of(coverage, [](int count) {
+        return count == 1;
+    }));
+
+    REQUIRE_THROWS(rad::make_tiles(image_size, cv::Size{0, 32}, overlap));
+    REQUIRE_THROWS(rad::make_tiles(image_size, tile_size, -1));
+}
+
+TEST_CASE("[tiled_raster] - RawRasterReader and RawRasterWriter", "[rad]")
+{
+    const fs::path root = fs::absolute("./test_raster");
+    fs::create_directories(root);
+    const cv::Size size{50, 40};
+    static constexpr std::size_t offset{16};
+
+    const auto bytes = make_raster_bytes(size, offset);
+    write_bytes(root / "input.raw", bytes);
+    const rad::RasterLayout layout{.size = size, .type = CV_8UC1, .offset = offset};
+
+    SECTION("Read region")
+    {
+        const rad::RawRasterReader reader{root / "input.raw", layout};
+        const cv::Rect roi{10, 5, 20, 15};
+        const cv::Mat region = reader.read(roi);
+        REQUIRE(region.size() == roi.size());
+        for (int y{0}; y < roi.height; ++y)
+        {
+            for (int x{0}; x < roi.width; ++x)
+            {
+                const auto expected = bytes[offset
+                                            + static_cast<std::size_t>(
+                                                ((roi.y + y) * size.width) + roi.x + x)];
+                REQUIRE(region.at<std::uint8_t>(y, x) == expected);
+            }
+        }
+
+        REQUIRE_THROWS(reader.read(cv::Rect{40, 0, 20, 10}));
+    }
+
+    SECTION("Round trip")
+    {
+        {
+            const rad::RawRasterReader reader{root / "input.raw", layout};
+            rad::RawRasterWriter writer{root / "output.raw", layout};
+            for (auto const& tile : rad::make_tiles(size, cv::Size{16, 16}, 3))
+            {
+                writer.write_tile(tile, reader.read(tile.roi));
+            }
+        }
+
+        REQUIRE(rad::read_file_bytes((root / "output.raw").string()) == bytes);
+    }
+
+    SECTION("Invalid arguments")
+    {
+        REQUIRE_THROWS(rad::RawRasterReader{root / "input.raw",
+                                            {.size = {100, 100}, .type = CV_8UC1}});
+        REQUIRE_THROWS(rad::RawRasterReader{root / "input.raw", {.size = {0, 10}}});
+
+        rad::RawRasterWriter writer{root / "output.raw", layout};
+        REQUIRE_THROWS(writer.write(cv::Rect{0, 0, 10, 10}, cv::Mat{5, 5, CV_8UC1}));
+        REQUIRE_THROWS(writer.write(cv::Rect{0, 0, 5, 5}, cv::Mat{5, 5, CV_8UC3}));
+    }
+
+    fs::remove_all(root);
+}
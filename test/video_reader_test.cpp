@@ -0,0 +1,70 @@
+#include "test_file_manager.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <opencv2/core/hal/interface.h>
+#include <opencv2/core/mat.hpp>
+#include <opencv2/core/types.hpp>
+#include <opencv2/videoio.hpp>
+#include <rad/video_reader.hpp>
+
+#include <cstddef>
+#include <filesystem>
+#include <string>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    constexpr int num_frames{20};
+    const cv::Size frame_size{64, 48};
+
+    std::string create_video(fs::path const& root)
+    {
+        const auto path = (root / "test_video.avi").string();
+        cv::VideoWriter writer{path,
+                               cv::VideoWriter::fourcc('M', 'J', 'P', 'G'),
+                               10.0,
+                               frame_size};
+        for (int i{0}; i < num_frames; ++i)
+        {
+            writer.write(cv::Mat{frame_size, CV_8UC3, cv::Scalar::all(i * 10)});
+        }
+
+        writer.release();
+        return path;
+    }
+} // namespace
+
+TEST_CASE("[video_reader] - VideoReader", "[rad]")
+{
+    const TestFileManager mgr{TestFileManager::Params{.num_files = 0}};
+    const auto path = create_video(mgr.root());
+
+    SECTION("Read all frames")
+    {
+        rad::VideoReader reader{path, 4};
+
+        std::size_t count{0};
+        while (auto frame = reader.next())
+        {
+            REQUIRE(frame->index == count);
+            REQUIRE(frame->img.size() == frame_size);
+            ++count;
+        }
+
+        REQUIRE(count == static_cast<std::size_t>(num_frames));
+        REQUIRE_FALSE(reader.next());
+    }
+
+    SECTION("Early destruction")
+    {
+        rad::VideoReader reader{path, 1};
+        REQUIRE(reader.next());
+    }
+
+    SECTION("Invalid arguments")
+    {
+        REQUIRE_THROWS(rad::VideoReader{(mgr.root() / "missing.avi").string()});
+        REQUIRE_THROWS(rad::VideoReader{path, 0});
+    }
+}
@@ -0,0 +1,80 @@
+#include <catch2/catch_test_macros.hpp>
+#include <oneapi/tbb/parallel_for.h>
+#include <oneapi/tbb/task_arena.h>
+#include <rad/worker_arena.hpp>
+#include <zeus/platform.hpp> // NOLINT(misc-include-cleaner)
+
+#include <atomic>
+#include <vector>
+
+#if defined(ZEUS_PLATFORM_LINUX)
+#    include <pthread.h>
+#    include <sched.h>
+#endif
+
+TEST_CASE("[worker_arena] - WorkerArena", "[rad]")
+{
+    SECTION("Max concurrency")
+    {
+        rad::WorkerArena arena{1};
+        REQUIRE(arena.max_concurrency() == 1);
+        REQUIRE(arena.cpus().empty());
+
+        const int concurrency = arena.execute([] {
+            return oneapi::tbb::this_task_arena::max_concurrency();
+        });
+        REQUIRE(concurrency == 1);
+    }
+
+    SECTION("Affinity")
+    {
+        rad::WorkerArena arena{1, {0}};
+        REQUIRE(arena.cpus() == std::vector<int>{0});
+
+        std::atomic<bool> pinned{true};
+        arena.execute([&pinned] {
+            oneapi::tbb::parallel_for(0, 16, [&pinned](int) {
+#if defined(ZEUS_PLATFORM_LINUX)
+                cpu_set_t mask;
+                CPU_ZERO(&mask);
+                pthread_getaffinity_np(pthread_self(), sizeof(mask), &mask);
+                if (CPU_COUNT(&mask) != 1 || !CPU_ISSET(0, &mask))
+                {
+                    pinned = false;
+                }
+#endif
+            });
+        });
+
+        REQUIRE(pinned);
+    }
+
+#if defined(ZEUS_PLATFORM_LINUX)
+    SECTION("Restores the thread mask")
+    {
+        auto get_mask = [] {
+            cpu_set_t mask;
+            CPU_ZERO(&mask);
+            pthread_getaffinity_np(pthread_self(), sizeof(mask), &mask);
+            return mask;
+        };
+
+        const auto before = get_mask();
+        {
+            rad::WorkerArena arena{1, {0}};
+            arena.execute([] {
+                oneapi::tbb::parallel_for(0, 16, [](int) {});
+            });
+        }
+
+        const auto after = get_mask();
+        REQUIRE(CPU_EQUAL(&before, &after));
+    }
+#endif
+
+    SECTION("Invalid arguments")
+    {
+        REQUIRE_THROWS(rad::WorkerArena{0});
+        REQUIRE_THROWS(rad::WorkerArena{1, {-1}});
+    }
+}